@@ -0,0 +1,98 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Arena.cpp                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 00:40:09 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 00:40:09 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Arena.hpp"
+#include <cstring>
+#include <new>
+
+static const size_t ALIGNMENT = 16;
+
+static size_t alignUp(size_t size) {
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+Arena::Arena()
+    : chunks(NULL), current(NULL), top(NULL), end(NULL) {
+}
+
+Arena::~Arena() {
+    while (chunks) {
+        Chunk* chunk = chunks;
+        chunks = chunk->next;
+        ::operator delete(chunk);
+    }
+}
+
+char* Arena::bytesOf(Chunk* chunk) {
+    return reinterpret_cast<char*>(chunk) + alignUp(sizeof(Chunk));
+}
+
+// moves on to the next kept chunk if it is big enough, else appends a new one
+void Arena::nextChunk(size_t size) {
+    Chunk* chunk = current ? current->next : chunks;
+    if (!chunk || chunk->size < size) {
+        size_t chunkSize = size > CHUNK_SIZE ? alignUp(size) : CHUNK_SIZE;
+        Chunk* fresh = static_cast<Chunk*>(::operator new(alignUp(sizeof(Chunk)) + chunkSize));
+        fresh->size = chunkSize;
+        fresh->next = chunk;
+        if (current)
+            current->next = fresh;
+        else
+            chunks = fresh;
+        chunk = fresh;
+    }
+    current = chunk;
+    top = bytesOf(chunk);
+    end = top + chunk->size;
+}
+
+void* Arena::allocate(size_t size) {
+    size = alignUp(size ? size : 1);
+    if (static_cast<size_t>(end - top) < size)
+        nextChunk(size);
+    void* memory = top;
+    top += size;
+    return memory;
+}
+
+void* Arena::extend(void* memory, size_t oldSize, size_t newSize) {
+    char* bytes = static_cast<char*>(memory);
+    size_t oldAligned = alignUp(oldSize);
+    size_t newAligned = alignUp(newSize);
+    // the newest allocation ends at top and may just take more of the chunk
+    if (bytes && bytes + oldAligned == top && static_cast<size_t>(end - bytes) >= newAligned) {
+        top = bytes + newAligned;
+        return memory;
+    }
+    void* moved = allocate(newSize);
+    if (oldSize)
+        std::memcpy(moved, memory, oldSize);
+    return moved;
+}
+
+// everything handed out since the last reset is dead now
+void Arena::reset() {
+    if (!chunks)
+        return;
+    // chunks beyond the first few only served a burst
+    Chunk* last = chunks;
+    for (size_t i = 1; i < KEEP_CHUNKS && last->next; i++)
+        last = last->next;
+    while (last->next) {
+        Chunk* spare = last->next;
+        last->next = spare->next;
+        ::operator delete(spare);
+    }
+    current = chunks;
+    top = bytesOf(chunks);
+    end = top + chunks->size;
+}
@@ -0,0 +1,54 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Arena.hpp                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 00:40:09 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 00:40:09 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+
+// bump allocator for data that only lives through one loop iteration, like
+// reply lines while a command is handled. allocating moves a pointer, nothing
+// is freed one by one; reset() at the end of the iteration rewinds it all.
+// one per reactor, owner thread only.
+class Arena {
+private:
+    struct Chunk {
+        Chunk* next;
+        size_t size;    // usable bytes behind the header
+    };
+
+    Chunk* chunks;      // in the order they are used
+    Chunk* current;     // the chunk being carved up
+    char* top;
+    char* end;
+
+    void nextChunk(size_t size);
+    static char* bytesOf(Chunk* chunk);
+
+    Arena(const Arena& other);
+    Arena& operator=(const Arena& other);
+
+public:
+    static const size_t CHUNK_SIZE = 16384;
+    // chunks kept over a reset, a burst beyond that goes back to the heap
+    static const size_t KEEP_CHUNKS = 4;
+
+    Arena();
+    ~Arena();
+
+    void* allocate(size_t size);
+    // grows the newest allocation in place when there is room, else moves it
+    void* extend(void* memory, size_t oldSize, size_t newSize);
+    void reset();
+};
+
+#endif
@@ -0,0 +1,74 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   BufferPool.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:58:36 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/16 23:08:10 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "BufferPool.hpp"
+#include <new>
+
+// bigger blocks go straight to the heap
+static const size_t classSizes[] = { 256, 1024, 4096, 8192 };
+static const int CLASS_COUNT = 4;
+// cached blocks per class and thread, the rest is freed
+static const int POOL_LIMIT = 128;
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+static __thread FreeBlock* freeBlocks[CLASS_COUNT];
+static __thread int freeCount[CLASS_COUNT];
+
+static int sizeClassOf(size_t size) {
+    for (int i = 0; i < CLASS_COUNT; i++) {
+        if (size <= classSizes[i])
+            return i;
+    }
+    return -1;
+}
+
+void* BufferPool::allocate(size_t& size) {
+    int sizeClass = sizeClassOf(size);
+    if (sizeClass < 0) {
+        return ::operator new(size);
+    }
+    size = classSizes[sizeClass];
+    FreeBlock* block = freeBlocks[sizeClass];
+    if (!block) {
+        return ::operator new(size);
+    }
+    freeBlocks[sizeClass] = block->next;
+    freeCount[sizeClass]--;
+    return block;
+}
+
+void BufferPool::deallocate(void* memory, size_t size) {
+    int sizeClass = sizeClassOf(size);
+    // only exact class sizes come from the pool
+    if (sizeClass < 0 || classSizes[sizeClass] != size || freeCount[sizeClass] >= POOL_LIMIT) {
+        ::operator delete(memory);
+        return;
+    }
+    FreeBlock* block = static_cast<FreeBlock*>(memory);
+    block->next = freeBlocks[sizeClass];
+    freeBlocks[sizeClass] = block;
+    freeCount[sizeClass]++;
+}
+
+void BufferPool::trim() {
+    for (int i = 0; i < CLASS_COUNT; i++) {
+        while (freeBlocks[i]) {
+            FreeBlock* block = freeBlocks[i];
+            freeBlocks[i] = block->next;
+            ::operator delete(block);
+        }
+        freeCount[i] = 0;
+    }
+}
@@ -0,0 +1,30 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   BufferPool.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:58:36 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/16 22:58:36 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef BUFFERPOOL_HPP
+#define BUFFERPOOL_HPP
+
+#include <cstddef>
+
+// per-thread free lists of I/O blocks in a few size classes.
+// a block may be freed by another thread than the one that allocated it,
+// it then simply joins the freeing thread's list.
+class BufferPool {
+public:
+    // rounds size up to the block actually handed out
+    static void* allocate(size_t& size);
+    static void deallocate(void* block, size_t size);
+    // hand the calling thread's cached blocks back to the heap
+    static void trim();
+};
+
+#endif
@@ -0,0 +1,30 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   CaseMap.hpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 23:20:41 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/16 23:20:41 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef CASEMAP_HPP
+#define CASEMAP_HPP
+
+#include <string>
+
+// RFC 1459 casemapping: A-Z fold to a-z and []\~ to {}|^, as the
+// Scandinavian lower-case forms. Nick and channel names compare folded.
+class CaseMap {
+private:
+    static const unsigned char foldTable[256];
+
+public:
+    static unsigned char fold(char c) { return foldTable[static_cast<unsigned char>(c)]; }
+    static std::string fold(const std::string& name);
+    static bool equals(const std::string& a, const std::string& b);
+};
+
+#endif
@@ -6,93 +6,184 @@
 /*   By: mvolgger <mvolgger@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/19 18:04:35 by mvolgger          #+#    #+#             */
-/*   Updated: 2025/12/20 14:40:43 by mvolgger         ###   ########.fr       */
+/*   Updated: 2026/10/17 02:44:23 by kbrauer          ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 
 #include "Channel.hpp"
 #include "Client.hpp"
-#include <algorithm>
-#include <sstream>
+#include "SharedBuffer.hpp"
+#include "Fanout.hpp"
+#include "SlabAllocator.hpp"
+#include "ReplyBuilder.hpp"
 
 Channel::Channel(const std::string& channelName) 
     : name(channelName), 
+      memberCount(0),
       inviteOnly(false), 
       topicRestricted(true),
       hasKey(false), 
       hasUserLimit(false),
-      userLimit(0) {
+      userLimit(0),
+      emptiedAt(0) {
 }
 
 Channel::~Channel() {
 }
 
+static SlabAllocator channelSlab("Channel", sizeof(Channel));
+
+void* Channel::operator new(size_t size) {
+    if (size != sizeof(Channel))
+        return ::operator new(size);
+    return channelSlab.allocate();
+}
+
+void Channel::operator delete(void* memory, size_t size) {
+    if (size != sizeof(Channel)) {
+        ::operator delete(memory);
+        return;
+    }
+    channelSlab.deallocate(memory);
+}
+
+// back to the state of a freshly created channel, leftover invites included
+void Channel::reset() {
+    while (!membership.empty()) {
+        setFlags(membership.keyAt(membership.size() - 1), 0);
+    }
+    topic.clear();
+    topicSetBy.clear();
+    key.clear();
+    inviteOnly = false;
+    topicRestricted = true;
+    hasKey = false;
+    hasUserLimit = false;
+    userLimit = 0;
+}
+
+unsigned int Channel::flagsOf(Client* client) const {
+    const unsigned int* flags = membership.find(client);
+    return flags ? *flags : 0;
+}
+
+// single place where flags change: keeps the member count and the client's mirror in step
+void Channel::setFlags(Client* client, unsigned int flags) {
+    unsigned int old = flagsOf(client);
+    if (flags == old)
+        return;
+    if ((old & MEMBER) && !(flags & MEMBER))
+        memberCount--;
+    else if (!(old & MEMBER) && (flags & MEMBER))
+        memberCount++;
+    if (flags)
+        membership.set(client, flags);
+    else
+        membership.erase(client);
+    client->setChannelFlags(this, flags);
+}
+
+// joining consumes a pending invite
 void Channel::addMember(Client* client) {
-    if (!isMember(client)) {
-        members.push_back(client);
-        client->addChannel(this);
-        // remove from invite list once they joined
-        inviteList.erase(client);
+    unsigned int flags = flagsOf(client);
+    if (!(flags & MEMBER)) {
+        setFlags(client, (flags & ~INVITED) | MEMBER);
     }
 }
 
+// drops every flag, a later rejoin starts from scratch
 void Channel::removeMember(Client* client) {
-    std::vector<Client*>::iterator it = std::find(members.begin(), members.end(), client);
-    if (it != members.end()) {
-        members.erase(it);
-        client->removeChannel(this);
-    }
-    operators.erase(client);
-    inviteList.erase(client);
+    setFlags(client, 0);
 }
 
 bool Channel::isMember(Client* client) const {
-    return std::find(members.begin(), members.end(), client) != members.end();
+    return (flagsOf(client) & MEMBER) != 0;
 }
 
 void Channel::addOperator(Client* client) {
-    if (isMember(client)) {
-        operators.insert(client);
+    unsigned int flags = flagsOf(client);
+    if (flags & MEMBER) {
+        setFlags(client, flags | OPERATOR);
     }
 }
 
 void Channel::removeOperator(Client* client) {
-    operators.erase(client);
+    setFlags(client, flagsOf(client) & ~OPERATOR);
 }
 
 bool Channel::isOperator(Client* client) const {
-    return operators.find(client) != operators.end();
+    return (flagsOf(client) & OPERATOR) != 0;
+}
+
+void Channel::addVoice(Client* client) {
+    unsigned int flags = flagsOf(client);
+    if (flags & MEMBER) {
+        setFlags(client, flags | VOICE);
+    }
+}
+
+void Channel::removeVoice(Client* client) {
+    setFlags(client, flagsOf(client) & ~VOICE);
+}
+
+bool Channel::isVoiced(Client* client) const {
+    return (flagsOf(client) & VOICE) != 0;
 }
 
 void Channel::addToInviteList(Client* client) {
-    inviteList.insert(client);
+    setFlags(client, flagsOf(client) | INVITED);
 }
 
 void Channel::removeFromInviteList(Client* client) {
-    inviteList.erase(client);
+    setFlags(client, flagsOf(client) & ~INVITED);
 }
 
 bool Channel::isInvited(Client* client) const {
-    return inviteList.find(client) != inviteList.end();
+    return (flagsOf(client) & INVITED) != 0;
 }
 
-void Channel::broadcast(const std::string& message, Client* exclude) {
-    for (size_t i = 0; i < members.size(); i++) {
-        if (members[i] != exclude) {
-            members[i]->queueMessage(message);
+// the line is serialized once, every member only gets a reference to it,
+// and each other reactor one delivery for all of its members.
+// droppable lines may be shed by members over their soft SendQ mark
+void Channel::broadcast(const StringRef& message, Client* exclude, bool droppable) {
+    SharedBuffer* buffer = SharedBuffer::fromLine(message);
+    Fanout fanout(buffer, droppable);
+    for (size_t i = 0; i < membership.size(); i++) {
+        Client* member = membership.keyAt(i);
+        if ((membership.valueAt(i) & MEMBER) && member != exclude) {
+            fanout.add(member);
         }
     }
+    fanout.post();
+    buffer->release();
 }
 
-std::vector<Client*> Channel::getMembersWithPendingData(Client* exclude) const {
-    std::vector<Client*> result;
-    for (size_t i = 0; i < members.size(); i++) {
-        if (members[i] != exclude && members[i]->hasDataToSend()) {
-            result.push_back(members[i]);
+void Channel::broadcast(const StringRef& header, const StringRef& body, Client* exclude, bool droppable) {
+    StringRef pieces[2] = { header, body };
+    size_t total = header.size() + body.size();
+    SharedBuffer* buffer = SharedBuffer::withCapacity(total + 2);
+    buffer->appendPieces(pieces, 2, total);
+    Fanout fanout(buffer, droppable);
+    for (size_t i = 0; i < membership.size(); i++) {
+        Client* member = membership.keyAt(i);
+        if ((membership.valueAt(i) & MEMBER) && member != exclude) {
+            fanout.add(member);
+        }
+    }
+    fanout.post();
+    buffer->release();
+}
+
+// part of a fan-out over several channels: members already stamped with
+// this epoch got the line through an earlier channel
+void Channel::broadcastOnce(Fanout& fanout, unsigned long epoch) {
+    for (size_t i = 0; i < membership.size(); i++) {
+        Client* member = membership.keyAt(i);
+        if ((membership.valueAt(i) & MEMBER) && member->markFanout(epoch)) {
+            fanout.add(member);
         }
     }
-    return result;
 }
 
 const std::string& Channel::getName() const {
@@ -111,10 +202,6 @@ const std::string& Channel::getKey() const {
     return key;
 }
 
-const std::vector<Client*>& Channel::getMembers() const {
-    return members;
-}
-
 bool Channel::getInviteOnly() const {
     return inviteOnly;
 }
@@ -135,6 +222,11 @@ size_t Channel::getUserLimit() const {
     return userLimit;
 }
 
+// a reused channel takes the case of whoever recreated it
+void Channel::setName(const std::string& channelName) {
+    name = channelName;
+}
+
 void Channel::setTopic(const std::string& newTopic, const std::string& setBy) { 
         topic = newTopic; 
         topicSetBy = setBy;
@@ -158,38 +250,36 @@ void Channel::setUserLimit(size_t limit) {
         hasUserLimit = (limit > 0); 
 }
 
-std::string Channel::getModeString() const {
-    std::string modes = "+";
-    std::string params = "";
-    
+// "+" and the set modes, followed by the limit when +l is on
+void Channel::appendModes(ReplyBuilder& modes) const {
+    modes << '+';
     if (inviteOnly)
-        modes += "i";
+        modes << 'i';
     if (topicRestricted)
-        modes += "t";
+        modes << 't';
     if (hasKey)
-        modes += "k";
-    if (hasUserLimit) {
-        modes += "l";
-        std::ostringstream oss;
-        oss << userLimit;
-        params += " " + oss.str();
-    }
-    if (modes == "+")
-        return "+";
-
-    return modes + params;
+        modes << 'k';
+    if (hasUserLimit)
+        modes << 'l' << ' ' << static_cast<unsigned long>(userLimit);
 }
 
-std::string Channel::getNamesReply(const std::string& requestingNick) const {
-    std::string result = "353 " + requestingNick + " = " + name + " :";
-    
-    for (size_t i = 0; i < members.size(); i++) {
-        if (i > 0) result += " ";
-        if (isOperator(members[i])) {
-            result += "@";
+bool Channel::appendNames(ReplyBuilder& names, size_t& position, size_t maxLength) const {
+    for (; position < membership.size(); position++) {
+        unsigned int flags = membership.valueAt(position);
+        if (!(flags & MEMBER))
+            continue;
+        const std::string& nick = membership.keyAt(position)->getNickname();
+        // separator, status mark and nick
+        size_t needed = (names.size() > 0 ? 1 : 0) + ((flags & (OPERATOR | VOICE)) ? 1 : 0) + nick.length();
+        if (names.size() > 0 && names.size() + needed > maxLength)
+            return true;
+        if (names.size() > 0) names << ' ';
+        if (flags & OPERATOR) {
+            names << '@';
+        } else if (flags & VOICE) {
+            names << '+';
         }
-        result += members[i]->getNickname();
+        names << nick;
     }
-    
-    return result;
+    return false;
 }
@@ -6,7 +6,7 @@
 /*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/10 15:18:52 by kbrauer           #+#    #+#             */
-/*   Updated: 2025/12/20 15:01:28 by kbrauer          ###   ########.fr       */
+/*   Updated: 2026/10/17 02:44:23 by kbrauer          ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -14,21 +14,33 @@
 #define CHANNEL_HPP
 
 #include <string>
-#include <vector>
-#include <set>
+#include "DenseIndex.hpp"
+#include "IntrusiveList.hpp"
+#include "StringRef.hpp"
 
 class Client;
+class ReplyBuilder;
+class Fanout;
 
 class Channel {
+public:
+    enum MemberFlag {
+        MEMBER   = 1,
+        OPERATOR = 2,
+        VOICE    = 4,
+        INVITED  = 8
+    };
+
 private:
     std::string name;
     std::string topic;
     std::string topicSetBy;
     std::string key;
     
-    std::vector<Client*> members;
-    std::set<Client*> operators;
-    std::set<Client*> inviteList;
+    // every client tied to the channel (member or pending invite) with its flags;
+    // the Client keeps the mirror entry
+    DenseIndex<Client*, unsigned int> membership;
+    size_t memberCount;
     
     // modes
     bool inviteOnly;      // +i
@@ -36,34 +48,53 @@ private:
     bool hasKey;          // +k
     bool hasUserLimit;    // +l
     size_t userLimit;
+    
+    // parked on the server's idle list while empty during the grace period
+    ListHook<Channel> idleHook;
+    unsigned long emptiedAt;    // monotonicMs() when it was parked
+    friend class Server;
+
+    unsigned int flagsOf(Client* client) const;
+    void setFlags(Client* client, unsigned int flags);
 
 public:
     Channel(const std::string& channelName);
     ~Channel();
     
+    // taken from the Channel slab pool
+    static void* operator new(size_t size);
+    static void operator delete(void* memory, size_t size);
+    
+    void reset();
+    
     void addMember(Client* client);
     void removeMember(Client* client);
     bool isMember(Client* client) const;
-    size_t getMemberCount() const { return members.size(); }
-    bool isEmpty() const { return members.empty(); }
+    size_t getMemberCount() const { return memberCount; }
+    bool isEmpty() const { return memberCount == 0; }
     
     void addOperator(Client* client);
     void removeOperator(Client* client);
     bool isOperator(Client* client) const;
     
+    void addVoice(Client* client);
+    void removeVoice(Client* client);
+    bool isVoiced(Client* client) const;
+    
     void addToInviteList(Client* client);
     void removeFromInviteList(Client* client);
     bool isInvited(Client* client) const;
     
-    void broadcast(const std::string& message, Client* exclude = NULL);
-    std::vector<Client*> getMembersWithPendingData(Client* exclude = NULL) const;
+    void broadcast(const StringRef& message, Client* exclude = NULL, bool droppable = false);
+    // header and body land in the shared buffer directly, the body is not copied twice
+    void broadcast(const StringRef& header, const StringRef& body, Client* exclude, bool droppable = false);
+    void broadcastOnce(Fanout& fanout, unsigned long epoch);
     
     // getters
     const std::string& getName() const ;
     const std::string& getTopic() const;
     const std::string& getTopicSetBy() const;
     const std::string& getKey() const;
-    const std::vector<Client*>& getMembers() const;
     bool getInviteOnly() const;
     bool getTopicRestricted() const;
     bool getHasKey() const;
@@ -71,6 +102,7 @@ public:
     size_t getUserLimit() const;
     
     // settlers
+    void setName(const std::string& channelName);
     void setTopic(const std::string& newTopic, const std::string& setBy);
     
     void setKey(const std::string& newKey);
@@ -78,9 +110,12 @@ public:
     void setTopicRestricted(bool mode);
     void setUserLimit(size_t limit);
     
-    std::string getModeString() const;
+    void appendModes(ReplyBuilder& modes) const;
     
-    std::string getNamesReply(const std::string& requestingNick) const;
+    // appends members from position on, "@" or "+" marked, while the list
+    // stays within maxLength; always takes at least one. returns true while
+    // members remain for another line
+    bool appendNames(ReplyBuilder& names, size_t& position, size_t maxLength) const;
 };
 
 #endif
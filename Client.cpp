@@ -6,42 +6,83 @@
 /*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/10 15:20:44 by kbrauer           #+#    #+#             */
-/*   Updated: 2025/12/20 15:00:54 by kbrauer          ###   ########.fr       */
+/*   Updated: 2026/10/17 02:47:56 by kbrauer          ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "Client.hpp"
+#include "Reactor.hpp"
+#include "Channel.hpp"
+#include "SharedBuffer.hpp"
+#include "SlabAllocator.hpp"
+#include "Logger.hpp"
 #include <sys/socket.h>
 #include <unistd.h>
-#include <iostream>
 #include <cerrno>
 
-Client::Client(int fd) 
+Client::Client(int fd, Reactor* reactor, unsigned long connectionId) 
     : socketFd(fd), 
-      isAuthenticated(false), 
+      markedForRemoval(false),
+      inputClosed(false),
+      sendInFlight(false),
+      sendqExceeded(false),
       isRegistered(false),
-      markedForRemoval(false) {
+      isAuthenticated(false), 
+      reactor(reactor),
+      sendqLimit(0),
+      sendqSoftLimit(0),
+      sendqDepth(0),
+      sendqPeak(0),
+      sendqDropped(0),
+      lastActivity(0),
+      pingSentAt(0),
+      lingerUntil(0),
+      fanoutMark(0),
+      connectionId(connectionId) {
 }
 
 Client::~Client() {
     close(socketFd);
 }
 
+// connections come and go all the time, keep their objects in one pool
+static SlabAllocator clientSlab("Client", sizeof(Client));
+
+void* Client::operator new(size_t size) {
+    if (size != sizeof(Client))
+        return ::operator new(size);
+    return clientSlab.allocate();
+}
+
+void Client::operator delete(void* memory, size_t size) {
+    if (size != sizeof(Client)) {
+        ::operator delete(memory);
+        return;
+    }
+    clientSlab.deallocate(memory);
+}
+
 // getters and setters
 int Client::getFd() const {
     return socketFd;
 }
+Reactor* Client::getReactor() const {
+    return reactor;
+}
+unsigned long Client::getConnectionId() const {
+    return connectionId;
+}
 const std::string& Client::getNickname() const {
-    return nickname;
+    return identity.nickname;
 }
 const std::string& Client::getUsername() const {
-    return username;
+    return identity.username;
 }
 const std::string& Client::getRealname() const {
-    return realname;
+    return identity.realname;
 }
 const std::string& Client::getHostname() const {
-    return hostname; }
+    return identity.hostname; }
 bool Client::getAuthenticated() const {
     return isAuthenticated;
 }
@@ -51,27 +92,58 @@ bool Client::getRegistered() const {
 bool Client::isMarkedForRemoval() const {
     return markedForRemoval;
 }
-std::string& Client::getInputBuffer() {
+bool Client::isInputClosed() const {
+    return inputClosed;
+}
+InputBuffer& Client::getInputBuffer() {
     return inputBuffer;
 }
-std::string& Client::getOutputBuffer() {
-    return outputBuffer;
+TokenBucket& Client::getFloodBucket() {
+    return floodBucket;
 }
-const std::set<Channel*>& Client::getJoinedChannels() const {
-    return joinedChannels;
+Timer& Client::getKeepalive() {
+    return keepalive;
+}
+unsigned long Client::getLastActivity() const {
+    return lastActivity;
+}
+unsigned long Client::getPingSentAt() const {
+    return pingSentAt;
+}
+unsigned long Client::getLingerUntil() const {
+    return lingerUntil;
+}
+// snapshots, so callers may leave channels while walking them
+std::vector<Channel*> Client::getJoinedChannels() const {
+    std::vector<Channel*> result;
+    for (size_t i = 0; i < channelFlags.size(); i++) {
+        if (channelFlags.valueAt(i) & Channel::MEMBER)
+            result.push_back(channelFlags.keyAt(i));
+    }
+    return result;
+}
+// joined channels plus pending invites
+std::vector<Channel*> Client::getLinkedChannels() const {
+    std::vector<Channel*> result;
+    for (size_t i = 0; i < channelFlags.size(); i++)
+        result.push_back(channelFlags.keyAt(i));
+    return result;
 }
 
 void Client::setNickname(const std::string& nick) {
-    nickname = nick;
+    identity.nickname = nick;
+    identity.rebuildPrefix();
 }
 void Client::setUsername(const std::string& user) {
-    username = user;
+    identity.username = user;
+    identity.rebuildPrefix();
 }
 void Client::setRealname(const std::string& real) {
-    realname = real;
+    identity.realname = real;
 }
 void Client::setHostname(const std::string& host) {
-    hostname = host;
+    identity.hostname = host;
+    identity.rebuildPrefix();
 }
 void Client::setAuthenticated(bool auth) {
     isAuthenticated = auth;
@@ -79,80 +151,235 @@ void Client::setAuthenticated(bool auth) {
 void Client::setRegistered(bool reg) {
     isRegistered = reg;
 }
+void Client::noteActivity(unsigned long now) {
+    lastActivity = now;
+}
+void Client::setPingSentAt(unsigned long now) {
+    pingSentAt = now;
+}
+void Client::setLingerUntil(unsigned long deadline) {
+    lingerUntil = deadline;
+}
+// owner thread only: the reactor removes the client at the end of its loop iteration
+void Client::setInputClosed(bool closed) {
+    inputClosed = closed;
+}
 void Client::setMarkedForRemoval(bool mark) {
     markedForRemoval = mark;
+    if (mark && reactor) {
+        reactor->markForRemoval(this);
+    }
 }
 
-void Client::addChannel(Channel* channel) {
-    joinedChannels.insert(channel);
+void Client::setChannelFlags(Channel* channel, unsigned int flags) {
+    if (flags)
+        channelFlags.set(channel, flags);
+    else
+        channelFlags.erase(channel);
 }
-void Client::removeChannel(Channel* channel) {
-    joinedChannels.erase(channel);
+// false when this fan-out already reached the client through another channel
+bool Client::markFanout(unsigned long epoch) {
+    if (fanoutMark == epoch)
+        return false;
+    fanoutMark = epoch;
+    return true;
 }
 
 
-// queue message to send: Adding to buffer. server poll loop will handle sending only when socket is ready 
-void Client::queueMessage(const std::string& message) {
-    std::string fullMessage = message;
-    
-    // ensure message ends with \r\n
-    if (fullMessage.length() < 2 || 
-        fullMessage.substr(fullMessage.length() - 2) != "\r\n") {
-        while (!fullMessage.empty() && 
-               (fullMessage[fullMessage.length() - 1] == '\r' || 
-                fullMessage[fullMessage.length() - 1] == '\n')) {
-            fullMessage.erase(fullMessage.length() - 1);
-        }
-        fullMessage += "\r\n";
+// queue message to send: copied into the tail chunk of the output queue.
+// server loop will handle sending only when socket is ready.
+void Client::queueMessage(const StringRef& message) {
+    if (reactor && reactor != Reactor::current()) {
+        SharedBuffer* buffer = SharedBuffer::fromLine(message);
+        reactor->post(this, buffer, false);
+        buffer->release();
+        return;
+    }
+    if (!admitOutput(message.size() + 2, false)) {
+        return;
+    }
+    outputQueue.appendLine(message);
+    noteSendQ();
+    if (reactor) {
+        reactor->markDirty(this);
     }
-    
-    outputBuffer += fullMessage;
 }
 
-// send data from output buffer. when buffer is empty means all data is sent
-bool Client::sendOutputBuffer() {
-    if (outputBuffer.empty()) {
+void Client::queueMessage(const StringRef& header, const StringRef& body) {
+    StringRef pieces[2] = { header, body };
+    queuePieces(pieces, 2, header.size() + body.size());
+}
+
+void Client::queuePieces(const StringRef* pieces, int count, size_t total) {
+    if (reactor && reactor != Reactor::current()) {
+        SharedBuffer* buffer = SharedBuffer::withCapacity(total + 2);
+        buffer->appendPieces(pieces, count, total);
+        reactor->post(this, buffer, false);
+        buffer->release();
+        return;
+    }
+    if (!admitOutput(total + 2, false)) {
+        return;
+    }
+    outputQueue.appendPieces(pieces, count, total);
+    noteSendQ();
+    if (reactor) {
+        reactor->markDirty(this);
+    }
+}
+
+// the queue belongs to the client's reactor thread, other threads go through its inbox
+void Client::queueBuffer(SharedBuffer* buffer, bool droppable) {
+    if (reactor && reactor != Reactor::current()) {
+        reactor->post(this, buffer, droppable);
+        return;
+    }
+    if (!admitOutput(buffer->size(), droppable)) {
+        return;
+    }
+    outputQueue.push(buffer);
+    noteSendQ();
+    if (reactor) {
+        reactor->markDirty(this);
+    }
+}
+
+// 0 leaves the queue unbounded (clients built outside the server)
+void Client::setSendQLimit(size_t limit, size_t softLimit) {
+    sendqLimit = limit;
+    sendqSoftLimit = softLimit;
+}
+
+// past the soft mark droppable lines are shed, past the hard limit the
+// client is cut off: a reader that stalls cannot grow our memory without bound
+bool Client::admitOutput(size_t length, bool droppable) {
+    if (sendqExceeded) {
+        return false;
+    }
+    if (sendqLimit == 0) {
         return true;
     }
-    
-    // track how many bites were sent
-    ssize_t bytesSent = send(socketFd, outputBuffer.c_str(), outputBuffer.length(), 0);
-    
-    if (bytesSent < 0) {
-        // no error but buffer is full
-        if (errno == EAGAIN || errno == EWOULDBLOCK) {
-            return false;
-        }
-        std::cerr << "Error sending to client " << socketFd << ": " << errno << std::endl;
+    size_t depth = outputQueue.bytes() + length;
+    if (depth > sendqLimit) {
+        closeForSendQ();
         return false;
     }
-    
-    if (bytesSent == 0) {
+    if (droppable && depth > sendqSoftLimit) {
+        __atomic_add_fetch(&sendqDropped, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    return true;
+}
+
+// the backlog is thrown away so the ERROR is next in line; bytes the kernel
+// is reading right now stay queued
+void Client::closeForSendQ() {
+    LOG(INFO) << "Client " << socketFd << " exceeded its SendQ of " << sendqLimit << " bytes";
+    sendqExceeded = true;
+    if (!sendInFlight) {
+        outputQueue.dropUnsent();
+    }
+    outputQueue.appendLine("ERROR :Closing Link: " + identity.hostname + " (SendQ exceeded)");
+    noteSendQ();
+    if (reactor) {
+        reactor->markDirty(this);
+    }
+    setMarkedForRemoval(true);
+}
+
+// published for STATS l, which runs on whichever reactor got the command
+void Client::noteSendQ() {
+    size_t depth = outputQueue.bytes();
+    __atomic_store_n(&sendqDepth, depth, __ATOMIC_RELAXED);
+    if (depth > sendqPeak) {
+        __atomic_store_n(&sendqPeak, depth, __ATOMIC_RELAXED);
+    }
+}
+
+size_t Client::getSendQLimit() const {
+    return sendqLimit;
+}
+
+size_t Client::getSendQDepth() const {
+    return __atomic_load_n(&sendqDepth, __ATOMIC_RELAXED);
+}
+
+size_t Client::getSendQPeak() const {
+    return __atomic_load_n(&sendqPeak, __ATOMIC_RELAXED);
+}
+
+unsigned long Client::getSendQDropped() const {
+    return __atomic_load_n(&sendqDropped, __ATOMIC_RELAXED);
+}
+
+// send data from output queue. when queue is empty means all data is sent.
+// keeps sending until the kernel buffer is full so edge-triggered backends
+// get a fresh writability edge for whatever is left
+bool Client::sendOutputBuffer() {
+    // bytes owned by the kernel right now would be overtaken
+    if (sendInFlight) {
         return false;
     }
+    struct iovec iov[MAX_SEND_IOV];
     
-    // re remove sent data from buffer
-    outputBuffer.erase(0, bytesSent);
+    while (!outputQueue.empty()) {
+        int count = outputQueue.fillIov(iov, MAX_SEND_IOV);
+        // gather as many queued lines as fit into one call
+        ssize_t bytesSent = writev(socketFd, iov, count);
+        
+        if (bytesSent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // no error but buffer is full
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return false;
+            }
+            LOG(ERROR) << "Error sending to client " << socketFd << ": " << errno;
+            return false;
+        }
+        
+        if (bytesSent == 0) {
+            return false;
+        }
+        
+        // move the cursor past what was sent
+        outputQueue.consume(bytesSent);
+        noteSendQ();
+    }
     
-    return outputBuffer.empty();
+    return true;
 }
 
 
 bool Client::hasDataToSend() const {
-    return !outputBuffer.empty();
+    return !outputQueue.empty();
+}
+
+// completion backends: the queued buffers never move or change, so the kernel
+// can read them while new lines get queued behind. the backend takes its own
+// reference on each buffer, the client may be gone before the send completes
+int Client::fillSendIov(struct iovec* iov, SharedBuffer** buffers, int maxCount) const {
+    return outputQueue.fillIov(iov, buffers, maxCount);
+}
+
+void Client::completeSend(size_t bytes) {
+    outputQueue.consume(bytes);
+    noteSendQ();
+}
+
+bool Client::isSendInFlight() const {
+    return sendInFlight;
+}
+
+void Client::setSendInFlight(bool inFlight) {
+    sendInFlight = inFlight;
 }
 
 // get the prefix of client for messages
 // format: nickname!username@hostname
-std::string Client::getPrefix() const {
-    std::string prefix = nickname;
-    if (!username.empty()) {
-        prefix += "!" + username;
-    }
-    if (!hostname.empty()) {
-        prefix += "@" + hostname;
-    }
-    return prefix;
+const std::string& Client::getPrefix() const {
+    return identity.prefix;
 }
 
 
@@ -6,7 +6,7 @@
 /*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/10 15:19:01 by kbrauer           #+#    #+#             */
-/*   Updated: 2025/12/20 15:01:01 by kbrauer          ###   ########.fr       */
+/*   Updated: 2026/10/17 02:47:56 by kbrauer          ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -14,33 +14,87 @@
 #define CLIENT_HPP
 
 #include <string>
-#include <set>
+#include <vector>
+#include <sys/uio.h>
+#include "OutputQueue.hpp"
+#include "InputBuffer.hpp"
+#include "IntrusiveList.hpp"
+#include "DenseIndex.hpp"
+#include "TokenBucket.hpp"
+#include "TimerWheel.hpp"
+#include "ClientIdentity.hpp"
 
 class Channel;
+class Reactor;
+class SharedBuffer;
 
+// the fields are ordered by how often the event loop touches them: what every
+// read or write event needs comes first and shares the first cache lines,
+// command-only identity data comes last
 class Client {
 private:
     int socketFd;
-    std::string nickname;
-    std::string username;
-    std::string realname;
-    std::string hostname;
-    
-    bool isAuthenticated;
-    bool isRegistered;
     bool markedForRemoval;
+    bool inputClosed;       // the peer sent EOF, only buffered lines are left
+    // completion backends: the front of the queue is owned by the kernel until the send completes
+    bool sendInFlight;
+    bool sendqExceeded;
+    bool isRegistered;
+    bool isAuthenticated;
+    Reactor* reactor;
+    
+    InputBuffer inputBuffer; 
+    OutputQueue outputQueue;
+    
+    // SendQ: owner thread only, except the depth counters read by STATS l
+    size_t sendqLimit;
+    size_t sendqSoftLimit;
+    size_t sendqDepth;
+    size_t sendqPeak;
+    unsigned long sendqDropped;
     
-    std::string inputBuffer; 
-    std::string outputBuffer; 
+    // membership in the reactor's pending-output and removal lists
+    ListHook<Client> dirtyHook;
+    ListHook<Client> removalHook;
+    ListHook<Client> backlogHook;
     
-    std::set<Channel*> joinedChannels;
+    TokenBucket floodBucket;
+    unsigned long lastActivity;     // ms of the last input
+    unsigned long pingSentAt;       // ms, 0 while no PING is outstanding
+    unsigned long lingerUntil;      // ms a dropped client's last lines may take, 0 if not dropped
+    // registration deadline, then idle PING and PONG deadline, then the
+    // linger deadline, on the reactor's wheel
+    Timer keepalive;
+    
+    // epoch of the last server-wide fan-out that reached this client
+    unsigned long fanoutMark;
+    unsigned long connectionId;
+    // mirror of the channels' membership tables: every channel this client
+    // is tied to (joined or invited) with the same flags word
+    DenseIndex<Channel*, unsigned int> channelFlags;
+    
+    ClientIdentity identity;
+    friend class Reactor;
+    
+    bool admitOutput(size_t length, bool droppable);
+    void closeForSendQ();
+    void noteSendQ();
 
 public:
-    Client(int fd);
+    // most lines gathered into one writev/sendmsg
+    static const int MAX_SEND_IOV = 64;
+
+    Client(int fd, Reactor* reactor, unsigned long connectionId);
     ~Client();
     
+    // taken from the Client slab pool
+    static void* operator new(size_t size);
+    static void operator delete(void* memory, size_t size);
+    
     // Getters
     int getFd() const;
+    Reactor* getReactor() const;
+    unsigned long getConnectionId() const;
     const std::string& getNickname() const;
     const std::string& getUsername() const;
     const std::string& getRealname() const;
@@ -48,9 +102,15 @@ public:
     bool getAuthenticated() const;
     bool getRegistered() const;
     bool isMarkedForRemoval() const;
-    std::string& getInputBuffer();
-    std::string& getOutputBuffer();
-    const std::set<Channel*>& getJoinedChannels() const;
+    bool isInputClosed() const;
+    InputBuffer& getInputBuffer();
+    TokenBucket& getFloodBucket();
+    Timer& getKeepalive();
+    unsigned long getLastActivity() const;
+    unsigned long getPingSentAt() const;
+    unsigned long getLingerUntil() const;
+    std::vector<Channel*> getJoinedChannels() const;
+    std::vector<Channel*> getLinkedChannels() const;
     
     // setters
     void setNickname(const std::string& nick);
@@ -60,15 +120,37 @@ public:
     void setAuthenticated(bool auth);
     void setRegistered(bool reg);
     void setMarkedForRemoval(bool mark);
+    void setInputClosed(bool closed);
+    void noteActivity(unsigned long now);
+    void setPingSentAt(unsigned long now);
+    void setLingerUntil(unsigned long deadline);
     
-    void addChannel(Channel* channel);
-    void removeChannel(Channel* channel);
+    // kept in step by Channel, 0 drops the entry
+    void setChannelFlags(Channel* channel, unsigned int flags);
+    bool markFanout(unsigned long epoch);
     
-    void queueMessage(const std::string& message);
+    void queueMessage(const StringRef& message);
+    // a line sent as a prebuilt header and a body, e.g. ":prefix PRIVMSG nick :" and the text
+    void queueMessage(const StringRef& header, const StringRef& body);
+    // a line gathered from pieces, e.g. a numeric reply, copied once
+    void queuePieces(const StringRef* pieces, int count, size_t total);
+    // droppable lines (channel chatter) are shed above the soft SendQ mark
+    void queueBuffer(SharedBuffer* buffer, bool droppable = false);
     bool sendOutputBuffer();
     bool hasDataToSend() const;
     
-    std::string getPrefix() const;
+    int fillSendIov(struct iovec* iov, SharedBuffer** buffers, int maxCount) const;
+    void completeSend(size_t bytes);
+    bool isSendInFlight() const;
+    void setSendInFlight(bool inFlight);
+    
+    const std::string& getPrefix() const;
+    
+    void setSendQLimit(size_t limit, size_t softLimit);
+    size_t getSendQLimit() const;
+    size_t getSendQDepth() const;
+    size_t getSendQPeak() const;
+    unsigned long getSendQDropped() const;
 };
 
 #endif
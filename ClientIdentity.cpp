@@ -0,0 +1,31 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ClientIdentity.cpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 01:07:40 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 02:47:56 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "ClientIdentity.hpp"
+
+ClientIdentity::ClientIdentity() {
+}
+
+ClientIdentity::~ClientIdentity() {
+}
+
+void ClientIdentity::rebuildPrefix() {
+    prefix = nickname;
+    if (!username.empty()) {
+        prefix += "!";
+        prefix += username;
+    }
+    if (!hostname.empty()) {
+        prefix += "@";
+        prefix += hostname;
+    }
+}
@@ -0,0 +1,41 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ClientIdentity.hpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 01:07:40 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 02:47:56 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef CLIENTIDENTITY_HPP
+#define CLIENTIDENTITY_HPP
+
+#include <string>
+
+// who a client is, as opposed to the connection state the reactor works on.
+// embedded at the end of the Client, behind everything the event loop needs.
+// nickname and prefix come first since every PRIVMSG reads them
+class ClientIdentity {
+private:
+    ClientIdentity(const ClientIdentity& other);
+    ClientIdentity& operator=(const ClientIdentity& other);
+
+public:
+    std::string nickname;
+    std::string prefix;     // nickname!username@hostname, see rebuildPrefix()
+    std::string username;
+    std::string hostname;
+    std::string realname;
+
+    ClientIdentity();
+    ~ClientIdentity();
+
+    // every message the client sends carries the prefix, so it is put
+    // together once here instead of per message
+    void rebuildPrefix();
+};
+
+#endif
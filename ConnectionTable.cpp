@@ -0,0 +1,76 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ConnectionTable.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:31:33 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 01:24:32 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "ConnectionTable.hpp"
+#include "Client.hpp"
+
+ConnectionTable::ConnectionTable() {
+}
+
+ConnectionTable::~ConnectionTable() {
+}
+
+void ConnectionTable::insert(Client* client, unsigned int interest) {
+    size_t fd = client->getFd();
+    if (fd >= slots.size()) {
+        Slot empty;
+        empty.client = NULL;
+        empty.denseIndex = 0;
+        empty.interest = 0;
+        // fds are handed out lowest-first, so doubling keeps resizes rare
+        size_t newSize = slots.empty() ? 64 : slots.size();
+        while (newSize <= fd)
+            newSize *= 2;
+        slots.resize(newSize, empty);
+    }
+    
+    Slot& slot = slots[fd];
+    slot.client = client;
+    slot.denseIndex = static_cast<unsigned int>(dense.size());
+    slot.interest = interest;
+    dense.push_back(client);
+}
+
+// move the last dense entry into the hole left by fd instead of shifting the array
+Client* ConnectionTable::erase(int fd) {
+    Client* client = find(fd);
+    if (!client)
+        return NULL;
+    
+    Slot& slot = slots[fd];
+    Client* last = dense.back();
+    dense[slot.denseIndex] = last;
+    slots[last->getFd()].denseIndex = slot.denseIndex;
+    dense.pop_back();
+    
+    slot.client = NULL;
+    slot.denseIndex = 0;
+    slot.interest = 0;
+    return client;
+}
+
+Client* ConnectionTable::find(int fd) const {
+    if (fd < 0 || (size_t)fd >= slots.size())
+        return NULL;
+    return slots[fd].client;
+}
+
+unsigned int ConnectionTable::getInterest(int fd) const {
+    if (!find(fd))
+        return 0;
+    return slots[fd].interest;
+}
+
+void ConnectionTable::setInterest(int fd, unsigned int interest) {
+    if (find(fd))
+        slots[fd].interest = interest;
+}
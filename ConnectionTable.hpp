@@ -0,0 +1,54 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ConnectionTable.hpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:31:33 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 01:24:32 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef CONNECTIONTABLE_HPP
+#define CONNECTIONTABLE_HPP
+
+#include <vector>
+#include <cstddef>
+
+class Client;
+
+// fd-indexed client table. Every fd owns a slot holding its Client, the
+// events currently registered with the backend and its position in the
+// dense client array, so lookups, interest updates and removals are O(1).
+// The dense array is kept gap-free with swap-remove for cheap iteration.
+// A slot is 16 bytes, four to a cache line, so the per-event lookup stays
+// cheap with 100k descriptors in the table.
+class ConnectionTable {
+private:
+    struct Slot {
+        Client* client;
+        unsigned int denseIndex;
+        unsigned int interest;
+    };
+    
+    std::vector<Slot> slots;
+    std::vector<Client*> dense;
+
+public:
+    ConnectionTable();
+    ~ConnectionTable();
+    
+    void insert(Client* client, unsigned int interest);
+    Client* erase(int fd);
+    Client* find(int fd) const;
+    
+    unsigned int getInterest(int fd) const;
+    void setInterest(int fd, unsigned int interest);
+    
+    // dense iteration: 0 <= i < size()
+    size_t size() const { return dense.size(); }
+    Client* at(size_t i) const { return dense[i]; }
+};
+
+#endif
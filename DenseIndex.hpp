@@ -0,0 +1,143 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   DenseIndex.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 23:23:42 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 00:38:33 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef DENSEINDEX_HPP
+#define DENSEINDEX_HPP
+
+#include <vector>
+#include <cstddef>
+#include "PoolAllocator.hpp"
+
+// pointer-keyed map kept as a dense entry array plus an open-addressing
+// (linear probing) index into it. Lookups, inserts and removals are O(1);
+// iteration walks the gap-free array, removal swaps the last entry into
+// the hole, so positions change when something is erased. Both arrays live
+// in the slab size classes, the tables are small and made in bulk.
+template <typename K, typename V>
+class DenseIndex {
+private:
+    struct Entry {
+        K key;
+        V value;
+    };
+
+    static const size_t EMPTY = static_cast<size_t>(-1);
+
+    typedef std::vector<Entry, PoolAllocator<Entry> > EntryArray;
+    typedef std::vector<size_t, PoolAllocator<size_t> > SlotArray;
+
+    EntryArray entries;
+    SlotArray slots;    // entry position or EMPTY, power-of-two count
+
+    static size_t hashKey(K key) {
+        size_t bits = reinterpret_cast<size_t>(key);
+        // pointers are aligned: drop the zero bits, then mix
+        bits >>= 4;
+        return bits * static_cast<size_t>(2654435761UL);
+    }
+
+    size_t mask() const { return slots.size() - 1; }
+
+    // slot holding key, or the empty slot where it would go
+    size_t probe(K key) const {
+        size_t slot = hashKey(key) & mask();
+        while (slots[slot] != EMPTY && entries[slots[slot]].key != key)
+            slot = (slot + 1) & mask();
+        return slot;
+    }
+
+    void grow() {
+        SlotArray resized(slots.empty() ? 8 : slots.size() * 2, EMPTY);
+        slots.swap(resized);
+        for (size_t i = 0; i < entries.size(); i++)
+            slots[probe(entries[i].key)] = i;
+    }
+
+    // backward-shift deletion keeps probe chains intact without tombstones
+    void clearSlot(size_t hole) {
+        size_t slot = hole;
+        while (true) {
+            slot = (slot + 1) & mask();
+            if (slots[slot] == EMPTY)
+                break;
+            size_t home = hashKey(entries[slots[slot]].key) & mask();
+            // the entry may move into the hole if its home is not between hole and slot
+            bool movable = (hole <= slot) ? (home <= hole || home > slot)
+                                          : (home <= hole && home > slot);
+            if (movable) {
+                slots[hole] = slots[slot];
+                hole = slot;
+            }
+        }
+        slots[hole] = EMPTY;
+    }
+
+public:
+    DenseIndex() {}
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    K keyAt(size_t i) const { return entries[i].key; }
+    V& valueAt(size_t i) { return entries[i].value; }
+    const V& valueAt(size_t i) const { return entries[i].value; }
+
+    V* find(K key) {
+        if (entries.empty())
+            return NULL;
+        size_t slot = probe(key);
+        return slots[slot] == EMPTY ? NULL : &entries[slots[slot]].value;
+    }
+
+    const V* find(K key) const {
+        return const_cast<DenseIndex*>(this)->find(key);
+    }
+
+    // inserts or overwrites
+    void set(K key, const V& value) {
+        if ((entries.size() + 1) * 2 > slots.size())
+            grow();
+        size_t slot = probe(key);
+        if (slots[slot] != EMPTY) {
+            entries[slots[slot]].value = value;
+            return;
+        }
+        Entry entry;
+        entry.key = key;
+        entry.value = value;
+        slots[slot] = entries.size();
+        entries.push_back(entry);
+    }
+
+    bool erase(K key) {
+        if (entries.empty())
+            return false;
+        size_t slot = probe(key);
+        if (slots[slot] == EMPTY)
+            return false;
+        size_t position = slots[slot];
+        clearSlot(slot);
+
+        // fill the gap in the dense array with the last entry
+        size_t last = entries.size() - 1;
+        if (position != last) {
+            entries[position] = entries[last];
+            slots[probe(entries[position].key)] = position;
+        }
+        entries.pop_back();
+        return true;
+    }
+};
+
+template <typename K, typename V>
+const size_t DenseIndex<K, V>::EMPTY;
+
+#endif
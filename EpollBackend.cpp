@@ -0,0 +1,109 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EpollBackend.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:29:31 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/16 22:48:34 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "EpollBackend.hpp"
+
+#ifdef __linux__
+
+#include <unistd.h>
+#include <cstring>
+#include <stdexcept>
+
+EpollBackend::EpollBackend() : epollFd(-1), kernelEvents(64) {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        throw std::runtime_error("Failed to create epoll instance");
+    }
+}
+
+EpollBackend::~EpollBackend() {
+    if (epollFd != -1) {
+        close(epollFd);
+    }
+}
+
+const char* EpollBackend::getName() const {
+    return "epoll";
+}
+
+bool EpollBackend::isEdgeTriggered() const {
+    return true;
+}
+
+unsigned int EpollBackend::toEpollEvents(unsigned int events) {
+    unsigned int result = EPOLLET | EPOLLRDHUP;
+    if (events & EVENT_READ)
+        result |= EPOLLIN;
+    if (events & EVENT_WRITE)
+        result |= EPOLLOUT;
+    return result;
+}
+
+bool EpollBackend::add(int fd, unsigned int events) {
+    struct epoll_event ev;
+    std::memset(&ev, 0, sizeof(ev));
+    ev.events = toEpollEvents(events);
+    ev.data.fd = fd;
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+// re-arming with EPOLL_CTL_MOD also re-reports a condition that is already
+// true, so enabling EPOLLOUT on a writable socket wakes us up right away
+bool EpollBackend::modify(int fd, unsigned int events) {
+    struct epoll_event ev;
+    std::memset(&ev, 0, sizeof(ev));
+    ev.events = toEpollEvents(events);
+    ev.data.fd = fd;
+    return epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+void EpollBackend::remove(int fd) {
+    struct epoll_event ev;
+    std::memset(&ev, 0, sizeof(ev));
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, &ev);
+}
+
+int EpollBackend::wait(std::vector<Event>& ready, int timeoutMs) {
+    ready.clear();
+    int count = epoll_wait(epollFd, &kernelEvents[0], kernelEvents.size(), timeoutMs);
+    if (count <= 0) {
+        return count;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        unsigned int kev = kernelEvents[i].events;
+        Event event;
+        event.fd = kernelEvents[i].data.fd;
+        event.events = 0;
+        event.result = 0;
+        event.data = NULL;
+        event.length = 0;
+        // a peer half-close shows up as readable so recv() can observe the EOF
+        if (kev & (EPOLLIN | EPOLLRDHUP))
+            event.events |= EVENT_READ;
+        if (kev & EPOLLOUT)
+            event.events |= EVENT_WRITE;
+        if (kev & EPOLLHUP)
+            event.events |= EVENT_HANGUP;
+        if (kev & EPOLLERR)
+            event.events |= EVENT_ERROR;
+        ready.push_back(event);
+    }
+    
+    // a full batch means more fds may be ready, give the next call more room
+    if ((size_t)count == kernelEvents.size()) {
+        kernelEvents.resize(kernelEvents.size() * 2);
+    }
+    return count;
+}
+
+#endif
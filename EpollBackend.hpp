@@ -0,0 +1,49 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EpollBackend.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:29:31 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/16 22:29:31 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef EPOLLBACKEND_HPP
+#define EPOLLBACKEND_HPP
+
+#include "EventBackend.hpp"
+
+#ifdef __linux__
+
+#include <sys/epoll.h>
+
+// edge-triggered epoll: the kernel keeps the interest list, so a wakeup
+// only costs O(ready fds) instead of O(registered fds)
+class EpollBackend : public EventBackend {
+private:
+    int epollFd;
+    std::vector<struct epoll_event> kernelEvents;
+
+    static unsigned int toEpollEvents(unsigned int events);
+
+    EpollBackend(const EpollBackend& other);
+    EpollBackend& operator=(const EpollBackend& other);
+
+public:
+    EpollBackend();
+    ~EpollBackend();
+
+    const char* getName() const;
+    bool isEdgeTriggered() const;
+
+    bool add(int fd, unsigned int events);
+    bool modify(int fd, unsigned int events);
+    void remove(int fd);
+    int wait(std::vector<Event>& ready, int timeoutMs);
+};
+
+#endif
+
+#endif
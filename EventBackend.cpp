@@ -0,0 +1,71 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EventBackend.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:29:30 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 01:50:44 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "EventBackend.hpp"
+#include "PollBackend.hpp"
+#include "EpollBackend.hpp"
+#include "IoUringBackend.hpp"
+#include "Logger.hpp"
+#include <stdexcept>
+
+EventBackend::~EventBackend() {
+}
+
+bool EventBackend::addListener(int fd) {
+    return add(fd, EVENT_READ);
+}
+
+bool EventBackend::addConnection(int fd) {
+    return add(fd, EVENT_READ);
+}
+
+bool EventBackend::completesIo() const {
+    return false;
+}
+
+bool EventBackend::submitSend(int fd, const struct iovec* iov, SharedBuffer* const* buffers, int count) {
+    (void)fd;
+    (void)iov;
+    (void)buffers;
+    (void)count;
+    return false;
+}
+
+EventBackend* EventBackend::create(const std::string& name) {
+#ifdef IO_URING_BACKEND
+    if (name == "io_uring") {
+        try {
+            return new IoUringBackend();
+        } catch (const std::exception& e) {
+            LOG(WARN) << "io_uring unavailable (" << e.what() << "), falling back to epoll";
+        }
+    }
+#else
+    if (name == "io_uring") {
+        LOG(WARN) << "io_uring support not built in, falling back to epoll";
+    }
+#endif
+#ifdef __linux__
+    if (name == "epoll" || name == "io_uring") {
+        try {
+            return new EpollBackend();
+        } catch (const std::exception& e) {
+            LOG(WARN) << "epoll unavailable (" << e.what() << "), falling back to poll";
+        }
+    }
+#else
+    if (name == "epoll" || name == "io_uring") {
+        LOG(WARN) << "epoll unavailable on this system, falling back to poll";
+    }
+#endif
+    return new PollBackend();
+}
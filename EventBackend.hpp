@@ -0,0 +1,78 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EventBackend.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:29:30 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 01:50:44 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef EVENTBACKEND_HPP
+#define EVENTBACKEND_HPP
+
+#include <string>
+#include <vector>
+#include <sys/uio.h>
+
+class SharedBuffer;
+
+// Event notification interface used by the server loop.
+// Implementations: PollBackend (portable fallback), EpollBackend (Linux, edge-triggered),
+// IoUringBackend (Linux, completion based: performs accept/recv/send itself)
+class EventBackend {
+public:
+    enum {
+        EVENT_READ = 0x01,
+        EVENT_WRITE = 0x02,
+        EVENT_HANGUP = 0x04,
+        EVENT_ERROR = 0x08,
+        // completion events, only reported when completesIo() is true
+        EVENT_ACCEPT = 0x10,    // result: accepted fd
+        EVENT_DATA = 0x20,      // data/length: received bytes, valid until the next wait()
+        EVENT_SENT = 0x40,      // result: bytes sent or -errno
+        EVENT_EOF = 0x80        // the peer closed its side, no more EVENT_DATA follows
+    };
+
+    struct Event {
+        int fd;
+        unsigned int events;
+        int result;
+        const char* data;
+        size_t length;
+    };
+
+    virtual ~EventBackend();
+
+    virtual const char* getName() const = 0;
+    // edge-triggered backends only report transitions, so callers must drain
+    // sockets until EAGAIN instead of relying on being woken up again
+    virtual bool isEdgeTriggered() const = 0;
+
+    virtual bool add(int fd, unsigned int events) = 0;
+    virtual bool modify(int fd, unsigned int events) = 0;
+    virtual void remove(int fd) = 0;
+
+    // listening and client sockets; readiness backends just watch them for reading
+    virtual bool addListener(int fd);
+    virtual bool addConnection(int fd);
+
+    // completion backends accept, receive and send on their own: the server
+    // hands them outgoing data with submitSend() instead of waiting for EVENT_WRITE.
+    // buffers[i] is the buffer iov[i] points into; the backend keeps a reference
+    // on each until the matching EVENT_SENT, so the sender may go away meanwhile
+    virtual bool completesIo() const;
+    virtual bool submitSend(int fd, const struct iovec* iov, SharedBuffer* const* buffers, int count);
+
+    // wait up to timeoutMs (-1 = forever) and fill ready with the fds that have events.
+    // returns the number of ready fds or -1 with errno set
+    virtual int wait(std::vector<Event>& ready, int timeoutMs) = 0;
+
+    // builds the requested backend ("io_uring", "epoll" or "poll"), falling back
+    // to epoll and then poll when the requested one is not available on this system
+    static EventBackend* create(const std::string& name);
+};
+
+#endif
@@ -0,0 +1,46 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Fanout.cpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 02:31:31 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 02:44:23 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Fanout.hpp"
+#include "Client.hpp"
+
+Fanout::Fanout(SharedBuffer* buffer, bool droppable)
+    : buffer(buffer),
+      droppable(droppable) {
+}
+
+void Fanout::add(Client* target) {
+    Reactor* reactor = target->getReactor();
+    if (!reactor || reactor == Reactor::current()) {
+        target->queueBuffer(buffer, droppable);
+        return;
+    }
+    // a handful of reactors at most, a linear search is enough
+    size_t i = 0;
+    while (i < groups.size() && groups[i].reactor != reactor)
+        i++;
+    if (i == groups.size()) {
+        groups.push_back(Group());
+        groups[i].reactor = reactor;
+    }
+    Reactor::Target entry;
+    entry.fd = target->getFd();
+    entry.connectionId = target->getConnectionId();
+    groups[i].targets.push_back(entry);
+}
+
+void Fanout::post() {
+    for (size_t i = 0; i < groups.size(); i++) {
+        groups[i].reactor->post(buffer, groups[i].targets, droppable);
+    }
+    groups.clear();
+}
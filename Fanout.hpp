@@ -0,0 +1,47 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Fanout.hpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 02:31:31 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 02:44:23 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef FANOUT_HPP
+#define FANOUT_HPP
+
+#include <vector>
+#include "Reactor.hpp"
+
+class Client;
+class SharedBuffer;
+
+// one line for many clients. clients of the calling reactor get it queued
+// right away, the others are collected per reactor and post() hands each
+// reactor a single delivery with all of its targets
+class Fanout {
+private:
+    struct Group {
+        Reactor* reactor;
+        std::vector<Reactor::Target> targets;
+    };
+
+    SharedBuffer* buffer;
+    bool droppable;
+    std::vector<Group> groups;
+
+    Fanout(const Fanout& other);
+    Fanout& operator=(const Fanout& other);
+
+public:
+    // the caller keeps its reference to the buffer until post() returns
+    Fanout(SharedBuffer* buffer, bool droppable = false);
+
+    void add(Client* target);
+    void post();
+};
+
+#endif
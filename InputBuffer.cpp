@@ -0,0 +1,166 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   InputBuffer.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:58:48 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 01:46:10 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "InputBuffer.hpp"
+#include "BufferPool.hpp"
+#include <cstring>
+
+// enough for several pipelined lines per recv(), or one line with tags
+static const size_t BLOCK_SIZE = 8192;
+
+// a tag section gets its own allowance on top of the line limit
+static bool exceedsLimit(const char* begin, size_t length) {
+    if (begin[0] != '@') {
+        return length > InputBuffer::MAX_LINE;
+    }
+    const char* space = static_cast<const char*>(std::memchr(begin, ' ', length));
+    if (!space) {
+        return length > InputBuffer::MAX_TAGS;
+    }
+    size_t tagLength = space - begin + 1;
+    return tagLength > InputBuffer::MAX_TAGS || length - tagLength > InputBuffer::MAX_LINE;
+}
+
+InputBuffer::InputBuffer()
+    : storage(NULL),
+      capacity(0),
+      start(0),
+      end(0),
+      discarding(false) {
+}
+
+InputBuffer::~InputBuffer() {
+    if (storage) {
+        BufferPool::deallocate(storage, capacity);
+    }
+}
+
+void InputBuffer::reserve() {
+    if (!storage) {
+        capacity = BLOCK_SIZE;
+        storage = static_cast<char*>(BufferPool::allocate(capacity));
+    }
+}
+
+char* InputBuffer::writePtr() {
+    reserve();
+    return storage + end;
+}
+
+size_t InputBuffer::space() {
+    reserve();
+    if (end == capacity && start > 0) {
+        compact();
+        reserve();
+    }
+    return capacity - end;
+}
+
+void InputBuffer::commit(size_t bytes) {
+    end += bytes;
+}
+
+size_t InputBuffer::append(const char* data, size_t length) {
+    size_t room = space();
+    if (length > room) {
+        length = room;
+    }
+    std::memcpy(storage + end, data, length);
+    end += length;
+    return length;
+}
+
+InputBuffer::LineStatus InputBuffer::nextLine(const char*& line, size_t& length) {
+    while (start < end) {
+        char* begin = storage + start;
+        size_t pending = end - start;
+        char* newline = static_cast<char*>(std::memchr(begin, '\n', pending));
+        
+        // rest of an overlong line, nothing to report anymore
+        if (discarding) {
+            if (!newline) {
+                start = end;
+                break;
+            }
+            start += newline - begin + 1;
+            discarding = false;
+            continue;
+        }
+        
+        if (!newline) {
+            // no newline within the limit: drop what we have and the rest of the line
+            if (exceedsLimit(begin, pending)) {
+                start = end;
+                discarding = true;
+                return LINE_TOO_LONG;
+            }
+            break;
+        }
+        
+        size_t lineLength = newline - begin + 1;
+        start += lineLength;
+        if (exceedsLimit(begin, lineLength)) {
+            return LINE_TOO_LONG;
+        }
+        length = lineLength - 1;
+        //REMOVE \r, only the \n is needed to find the end of cmd
+        if (length > 0 && begin[length - 1] == '\r') {
+            length--;
+        }
+        line = begin;
+        return LINE_READY;
+    }
+    return LINE_NONE;
+}
+
+bool InputBuffer::hasLine() const {
+    if (start == end) {
+        return false;
+    }
+    const char* begin = storage + start;
+    size_t pending = end - start;
+    // the tail of a dropped line is skipped by nextLine(), it is no line of its own
+    if (discarding) {
+        const char* newline = static_cast<const char*>(std::memchr(begin, '\n', pending));
+        if (!newline) {
+            return false;
+        }
+        pending -= newline - begin + 1;
+        begin = newline + 1;
+        if (pending == 0) {
+            return false;
+        }
+    }
+    if (std::memchr(begin, '\n', pending)) {
+        return true;
+    }
+    return exceedsLimit(begin, pending);
+}
+
+void InputBuffer::compact() {
+    if (!storage) {
+        return;
+    }
+    if (start == end) {
+        BufferPool::deallocate(storage, capacity);
+        storage = NULL;
+        capacity = 0;
+        start = 0;
+        end = 0;
+        return;
+    }
+    if (start > 0) {
+        std::memmove(storage, storage + start, end - start);
+        end -= start;
+        start = 0;
+    }
+}
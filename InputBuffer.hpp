@@ -0,0 +1,66 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   InputBuffer.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:58:48 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 00:09:51 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef INPUTBUFFER_HPP
+#define INPUTBUFFER_HPP
+
+#include <cstddef>
+
+// per-client receive buffer: the socket is read straight into one pooled block
+// and complete lines are handed out as pointers into it. lines longer than the
+// IRC limit are dropped up to their newline, so the block never has to grow.
+// an empty buffer gives its block back.
+class InputBuffer {
+public:
+    // RFC 1459: 512 bytes including the trailing \r\n
+    static const size_t MAX_LINE = 512;
+    // IRCv3: client tags may add up to 4096 bytes ('@' and space included) in front
+    static const size_t MAX_TAGS = 4096;
+
+    enum LineStatus {
+        LINE_NONE,      // no complete line buffered
+        LINE_READY,     // line/length point at the line, without \r\n
+        LINE_TOO_LONG   // a line over MAX_LINE was dropped
+    };
+
+private:
+    char* storage;
+    size_t capacity;
+    size_t start;       // first unconsumed byte
+    size_t end;         // one past the last received byte
+    bool discarding;    // inside an overlong line, skip to its newline
+
+    void reserve();
+
+    InputBuffer(const InputBuffer& other);
+    InputBuffer& operator=(const InputBuffer& other);
+
+public:
+    InputBuffer();
+    ~InputBuffer();
+
+    // free space for recv(), zero when the buffered lines have to be processed first
+    char* writePtr();
+    size_t space();
+    void commit(size_t bytes);
+    // copies as much as fits, returns the number of bytes taken
+    size_t append(const char* data, size_t length);
+
+    // the returned line stays valid until the next commit()/append()/compact()
+    LineStatus nextLine(const char*& line, size_t& length);
+    // true when nextLine() has a line (or an overlong one) to report
+    bool hasLine() const;
+    // moves a partial line to the front, or releases the block when nothing is left
+    void compact();
+};
+
+#endif
@@ -0,0 +1,88 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   IntrusiveList.hpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 23:10:33 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 00:09:51 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef INTRUSIVELIST_HPP
+#define INTRUSIVELIST_HPP
+
+#include <cstddef>
+
+// links embedded in the listed object, one hook per list it can be on
+template <typename T>
+struct ListHook {
+    T* prev;
+    T* next;
+    bool linked;
+
+    ListHook() : prev(NULL), next(NULL), linked(false) {}
+};
+
+// doubly linked list threaded through T::*Hook: no allocation, O(1) insert
+// and removal, and an object is never on the same list twice
+template <typename T, ListHook<T> T::*Hook>
+class IntrusiveList {
+private:
+    T* head;
+    T* tail;
+
+    IntrusiveList(const IntrusiveList& other);
+    IntrusiveList& operator=(const IntrusiveList& other);
+
+public:
+    IntrusiveList() : head(NULL), tail(NULL) {}
+
+    bool empty() const { return head == NULL; }
+    bool contains(const T* item) const { return (item->*Hook).linked; }
+    T* front() const { return head; }
+    T* back() const { return tail; }
+    static T* next(const T* item) { return (item->*Hook).next; }
+
+    // does nothing when the item is already listed
+    void pushBack(T* item) {
+        ListHook<T>& hook = item->*Hook;
+        if (hook.linked)
+            return;
+        hook.prev = tail;
+        hook.next = NULL;
+        hook.linked = true;
+        if (tail)
+            (tail->*Hook).next = item;
+        else
+            head = item;
+        tail = item;
+    }
+
+    void remove(T* item) {
+        ListHook<T>& hook = item->*Hook;
+        if (!hook.linked)
+            return;
+        if (hook.prev)
+            (hook.prev->*Hook).next = hook.next;
+        else
+            head = hook.next;
+        if (hook.next)
+            (hook.next->*Hook).prev = hook.prev;
+        else
+            tail = hook.prev;
+        hook.prev = NULL;
+        hook.next = NULL;
+        hook.linked = false;
+    }
+
+    T* popFront() {
+        T* item = head;
+        if (item)
+            remove(item);
+        return item;
+    }
+};
+
+#endif
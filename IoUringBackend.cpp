@@ -0,0 +1,637 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   IoUringBackend.cpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:42:23 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 01:50:44 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "IoUringBackend.hpp"
+#include "SharedBuffer.hpp"
+
+#ifdef IO_URING_BACKEND
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <poll.h>
+#include <unistd.h>
+#include <csignal>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <stdexcept>
+
+IoUringBackend::IoUringBackend()
+    : ringFd(-1),
+      ringMemory(MAP_FAILED),
+      ringSize(0),
+      sqes(NULL),
+      sqesSize(0),
+      sqLocalTail(0),
+      bufferRing(NULL),
+      bufferRingSize(0),
+      bufferMemory(NULL),
+      bufferTail(0) {
+    try {
+        setup();
+        checkSupportedOps();
+        setupBufferRing();
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+IoUringBackend::~IoUringBackend() {
+    release();
+}
+
+void IoUringBackend::release() {
+    cancelAll();
+    for (size_t i = 0; i < sendSlots.size(); i++) {
+        SendSlot* slot = sendSlots[i];
+        for (int j = 0; slot->used && j < slot->bufferCount; j++) {
+            slot->buffers[j]->release();
+        }
+        delete slot;
+    }
+    sendSlots.clear();
+    if (bufferMemory)
+        munmap(bufferMemory, (size_t)BUFFER_COUNT * BUFFER_SIZE);
+    if (bufferRing)
+        munmap(bufferRing, bufferRingSize);
+    if (sqes)
+        munmap(sqes, sqesSize);
+    if (ringMemory != MAP_FAILED)
+        munmap(ringMemory, ringSize);
+    if (ringFd != -1)
+        close(ringFd);
+    bufferMemory = NULL;
+    bufferRing = NULL;
+    sqes = NULL;
+    ringMemory = MAP_FAILED;
+    ringFd = -1;
+}
+
+// pending requests hold references to their sockets (the listener included),
+// so they are cancelled and reaped before the ring goes away; otherwise the
+// port stays busy until the kernel finishes tearing the ring down
+void IoUringBackend::cancelAll() {
+    if (ringFd == -1 || ringMemory == MAP_FAILED || !sqes)
+        return;
+    struct io_uring_sqe* sqe = nextSqe();
+    if (!sqe)
+        return;
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->cancel_flags = IORING_ASYNC_CANCEL_ANY | IORING_ASYNC_CANCEL_ALL;
+    sqe->user_data = packUserData(OP_CANCEL, 1, 0);
+    
+    bool cancelled = false;
+    while (!cancelled) {
+        if (enter(1, 100) < 0 && errno != EINTR)
+            break;
+        unsigned int head = *cqHead;
+        unsigned int tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        if (head == tail)
+            break;
+        for (; head != tail; head++) {
+            if (cqes[head & cqMask].user_data == packUserData(OP_CANCEL, 1, 0))
+                cancelled = true;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+}
+
+void IoUringBackend::setup() {
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    // multishot requests produce many completions per submission
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = COMPLETION_ENTRIES;
+    
+    ringFd = syscall(__NR_io_uring_setup, RING_ENTRIES, &params);
+    if (ringFd < 0) {
+        throw std::runtime_error("io_uring_setup failed");
+    }
+    unsigned int required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+    if ((params.features & required) != required) {
+        throw std::runtime_error("kernel lacks required io_uring features");
+    }
+    
+    // submission and completion rings share one mapping
+    size_t sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    size_t cqSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ringSize = sqSize > cqSize ? sqSize : cqSize;
+    ringMemory = mmap(NULL, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ringFd, IORING_OFF_SQ_RING);
+    if (ringMemory == MAP_FAILED) {
+        throw std::runtime_error("failed to map io_uring rings");
+    }
+    sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqeMemory = mmap(NULL, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           ringFd, IORING_OFF_SQES);
+    if (sqeMemory == MAP_FAILED) {
+        throw std::runtime_error("failed to map io_uring submission entries");
+    }
+    sqes = static_cast<struct io_uring_sqe*>(sqeMemory);
+    
+    char* base = static_cast<char*>(ringMemory);
+    sqHead = reinterpret_cast<unsigned int*>(base + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned int*>(base + params.sq_off.tail);
+    sqMask = *reinterpret_cast<unsigned int*>(base + params.sq_off.ring_mask);
+    sqEntries = params.sq_entries;
+    sqArray = reinterpret_cast<unsigned int*>(base + params.sq_off.array);
+    sqLocalTail = *sqTail;
+    
+    cqHead = reinterpret_cast<unsigned int*>(base + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned int*>(base + params.cq_off.tail);
+    cqMask = *reinterpret_cast<unsigned int*>(base + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<struct io_uring_cqe*>(base + params.cq_off.cqes);
+}
+
+// only the opcodes this backend submits. multishot recv has no feature bit:
+// a kernel too old for it fails the recv with -EINVAL, which drops that client
+void IoUringBackend::checkSupportedOps() {
+    size_t probeSize = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe* probe = static_cast<struct io_uring_probe*>(std::calloc(1, probeSize));
+    if (!probe) {
+        throw std::runtime_error("out of memory");
+    }
+    if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, probe, 256) < 0) {
+        std::free(probe);
+        throw std::runtime_error("io_uring probe failed");
+    }
+    const int needed[] = {
+        IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SENDMSG,
+        IORING_OP_POLL_ADD, IORING_OP_ASYNC_CANCEL
+    };
+    bool supported = true;
+    for (size_t i = 0; i < sizeof(needed) / sizeof(needed[0]); i++) {
+        int op = needed[i];
+        if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+            supported = false;
+        }
+    }
+    std::free(probe);
+    if (!supported) {
+        throw std::runtime_error("kernel lacks required io_uring operations");
+    }
+}
+
+void IoUringBackend::setupBufferRing() {
+    bufferRingSize = BUFFER_COUNT * sizeof(struct io_uring_buf);
+    void* ring = mmap(NULL, bufferRingSize, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED) {
+        throw std::runtime_error("failed to allocate buffer ring");
+    }
+    bufferRing = static_cast<struct io_uring_buf*>(ring);
+    void* memory = mmap(NULL, (size_t)BUFFER_COUNT * BUFFER_SIZE, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw std::runtime_error("failed to allocate receive buffers");
+    }
+    bufferMemory = static_cast<char*>(memory);
+    
+    struct io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<unsigned long>(bufferRing);
+    reg.ring_entries = BUFFER_COUNT;
+    reg.bgid = BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        throw std::runtime_error("failed to register buffer ring");
+    }
+    for (unsigned short i = 0; i < BUFFER_COUNT; i++) {
+        provideBuffer(i);
+    }
+    publishBuffers();
+}
+
+const char* IoUringBackend::getName() const {
+    return "io_uring";
+}
+
+bool IoUringBackend::isEdgeTriggered() const {
+    return false;
+}
+
+bool IoUringBackend::completesIo() const {
+    return true;
+}
+
+// user_data layout: operation (8 bits) | generation (24 bits) | fd or send slot (32 bits)
+__u64 IoUringBackend::packUserData(int op, unsigned int generation, unsigned int target) {
+    return ((__u64)op << 56) | ((__u64)(generation & 0xffffff) << 32) | target;
+}
+
+IoUringBackend::Registration& IoUringBackend::registration(int fd) {
+    if ((size_t)fd >= registrations.size()) {
+        Registration empty;
+        empty.kind = KIND_NONE;
+        empty.generation = 0;
+        size_t newSize = registrations.empty() ? 64 : registrations.size();
+        while (newSize <= (size_t)fd)
+            newSize *= 2;
+        registrations.resize(newSize, empty);
+    }
+    return registrations[fd];
+}
+
+struct io_uring_sqe* IoUringBackend::nextSqe() {
+    unsigned int head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    if (sqLocalTail - head >= sqEntries) {
+        // ring full: push what we have to the kernel without waiting
+        enter(0, 0);
+        head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (sqLocalTail - head >= sqEntries)
+            return NULL;
+    }
+    unsigned int index = sqLocalTail & sqMask;
+    struct io_uring_sqe* sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqArray[index] = index;
+    sqLocalTail++;
+    return sqe;
+}
+
+// submits everything queued since the last call and optionally waits for completions
+int IoUringBackend::enter(unsigned int minComplete, int timeoutMs) {
+    __atomic_store_n(sqTail, sqLocalTail, __ATOMIC_RELEASE);
+    unsigned int toSubmit = sqLocalTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    unsigned int flags = 0;
+    struct io_uring_getevents_arg arg;
+    struct __kernel_timespec timeout;
+    void* argPtr = NULL;
+    size_t argSize = 0;
+    
+    if (minComplete > 0) {
+        flags |= IORING_ENTER_GETEVENTS;
+        if (timeoutMs >= 0) {
+            std::memset(&arg, 0, sizeof(arg));
+            timeout.tv_sec = timeoutMs / 1000;
+            timeout.tv_nsec = (long long)(timeoutMs % 1000) * 1000000;
+            arg.ts = reinterpret_cast<unsigned long>(&timeout);
+            flags |= IORING_ENTER_EXT_ARG;
+            argPtr = &arg;
+            argSize = sizeof(arg);
+        }
+    }
+    if (toSubmit == 0 && minComplete == 0)
+        return 0;
+    return syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, argPtr, argSize);
+}
+
+void IoUringBackend::provideBuffer(unsigned short bufferId) {
+    struct io_uring_buf* entry = &bufferRing[bufferTail & (BUFFER_COUNT - 1)];
+    entry->addr = reinterpret_cast<unsigned long>(bufferMemory + (size_t)bufferId * BUFFER_SIZE);
+    entry->len = BUFFER_SIZE;
+    entry->bid = bufferId;
+    bufferTail++;
+}
+
+// the ring tail overlays the reserved field of the first entry
+void IoUringBackend::publishBuffers() {
+    __atomic_store_n(&bufferRing[0].resv, bufferTail, __ATOMIC_RELEASE);
+}
+
+void IoUringBackend::armAccept(int fd) {
+    struct io_uring_sqe* sqe = nextSqe();
+    if (!sqe) {
+        defer(OP_ACCEPT, registration(fd).generation, fd, 0);
+        return;
+    }
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe->user_data = packUserData(OP_ACCEPT, registration(fd).generation, fd);
+}
+
+void IoUringBackend::armRecv(int fd) {
+    struct io_uring_sqe* sqe = nextSqe();
+    if (!sqe) {
+        defer(OP_RECV, registration(fd).generation, fd, 0);
+        return;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->user_data = packUserData(OP_RECV, registration(fd).generation, fd);
+}
+
+void IoUringBackend::armPoll(int fd) {
+    struct io_uring_sqe* sqe = nextSqe();
+    if (!sqe) {
+        defer(OP_POLL, registration(fd).generation, fd, 0);
+        return;
+    }
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = packUserData(OP_POLL, registration(fd).generation, fd);
+}
+
+void IoUringBackend::cancel(__u64 target) {
+    struct io_uring_sqe* sqe = nextSqe();
+    if (!sqe) {
+        defer(OP_CANCEL, 0, 0, target);
+        return;
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = target;
+    sqe->user_data = packUserData(OP_CANCEL, 0, 0);
+}
+
+bool IoUringBackend::add(int fd, unsigned int events) {
+    (void)events;
+    Registration& reg = registration(fd);
+    reg.kind = KIND_POLL;
+    armPoll(fd);
+    return true;
+}
+
+bool IoUringBackend::addListener(int fd) {
+    Registration& reg = registration(fd);
+    reg.kind = KIND_LISTENER;
+    armAccept(fd);
+    return true;
+}
+
+bool IoUringBackend::addConnection(int fd) {
+    Registration& reg = registration(fd);
+    reg.kind = KIND_CONNECTION;
+    reg.generation++;
+    armRecv(fd);
+    return true;
+}
+
+// sends are submitted explicitly, there is no write interest to track
+bool IoUringBackend::modify(int fd, unsigned int events) {
+    (void)fd;
+    (void)events;
+    return true;
+}
+
+// completions still in flight for this fd carry the old generation and are dropped.
+void IoUringBackend::remove(int fd) {
+    if (fd < 0 || (size_t)fd >= registrations.size())
+        return;
+    Registration& reg = registrations[fd];
+    if (reg.kind == KIND_CONNECTION) {
+        cancel(packUserData(OP_RECV, reg.generation, fd));
+        for (size_t i = 0; i < sendSlots.size(); i++) {
+            SendSlot* slot = sendSlots[i];
+            if (slot->used && slot->fd == fd && slot->generation == reg.generation) {
+                cancel(packUserData(OP_SEND, 0, i));
+                cancel(packUserData(OP_SEND_WAIT, 0, i));
+            }
+        }
+    }
+    reg.kind = KIND_NONE;
+    reg.generation++;
+    // SQEs name the fd, which the caller is about to close: submit them
+    // (a last queued send included) while it still refers to this socket
+    enter(0, 0);
+}
+
+bool IoUringBackend::submitSend(int fd, const struct iovec* iov, SharedBuffer* const* buffers, int count) {
+    size_t slotIndex;
+    if (!freeSendSlots.empty()) {
+        slotIndex = freeSendSlots.back();
+        freeSendSlots.pop_back();
+    } else {
+        slotIndex = sendSlots.size();
+        sendSlots.push_back(new SendSlot);
+    }
+    SendSlot* slot = sendSlots[slotIndex];
+    if (count > MAX_SEND_IOV)
+        count = MAX_SEND_IOV;
+    
+    slot->fd = fd;
+    slot->generation = registration(fd).generation;
+    slot->used = true;
+    std::memset(&slot->message, 0, sizeof(slot->message));
+    std::memcpy(slot->iov, iov, count * sizeof(struct iovec));
+    for (int i = 0; i < count; i++) {
+        buffers[i]->retain();
+        slot->buffers[i] = buffers[i];
+    }
+    slot->bufferCount = count;
+    slot->message.msg_iov = slot->iov;
+    slot->message.msg_iovlen = count;
+    issueSend(slotIndex);
+    return true;
+}
+
+void IoUringBackend::issueSend(size_t slotIndex) {
+    SendSlot* slot = sendSlots[slotIndex];
+    struct io_uring_sqe* sqe = nextSqe();
+    if (!sqe) {
+        defer(OP_SEND, slot->generation, slotIndex, 0);
+        return;
+    }
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = slot->fd;
+    sqe->addr = reinterpret_cast<unsigned long>(&slot->message);
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = packUserData(OP_SEND, 0, slotIndex);
+}
+
+// the socket is non-blocking, so a full send buffer comes back as -EAGAIN:
+// wait for POLLOUT and retry with the same slot
+void IoUringBackend::waitWritable(size_t slotIndex) {
+    struct io_uring_sqe* sqe = nextSqe();
+    if (!sqe) {
+        defer(OP_SEND_WAIT, sendSlots[slotIndex]->generation, slotIndex, 0);
+        return;
+    }
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = sendSlots[slotIndex]->fd;
+    sqe->poll32_events = POLLOUT;
+    sqe->user_data = packUserData(OP_SEND_WAIT, 0, slotIndex);
+}
+
+// the kernel is done with the slot: drop its buffer references
+void IoUringBackend::finishSend(size_t slotIndex) {
+    SendSlot* slot = sendSlots[slotIndex];
+    for (int i = 0; i < slot->bufferCount; i++) {
+        slot->buffers[i]->release();
+    }
+    slot->bufferCount = 0;
+    slot->used = false;
+    freeSendSlots.push_back(slotIndex);
+}
+
+void IoUringBackend::defer(int op, unsigned int generation, unsigned int target, __u64 cancelTarget) {
+    Deferred request;
+    request.op = op;
+    request.generation = generation;
+    request.target = target;
+    request.cancelTarget = cancelTarget;
+    deferred.push_back(request);
+}
+
+// requests for a connection that has been removed since are dropped; a send
+// that will never go out just gives its buffers back
+void IoUringBackend::issueDeferred() {
+    std::vector<Deferred> requests;
+    requests.swap(deferred);
+    for (size_t i = 0; i < requests.size(); i++) {
+        const Deferred& request = requests[i];
+        if (request.op == OP_CANCEL) {
+            cancel(request.cancelTarget);
+            continue;
+        }
+        if (request.op == OP_SEND || request.op == OP_SEND_WAIT) {
+            SendSlot* slot = sendSlots[request.target];
+            if (registration(slot->fd).generation != slot->generation)
+                finishSend(request.target);
+            else if (request.op == OP_SEND)
+                issueSend(request.target);
+            else
+                waitWritable(request.target);
+            continue;
+        }
+        Registration& reg = registration(request.target);
+        if (reg.generation != request.generation)
+            continue;
+        if (request.op == OP_RECV && reg.kind == KIND_CONNECTION)
+            armRecv(request.target);
+        else if (request.op == OP_ACCEPT && reg.kind == KIND_LISTENER)
+            armAccept(request.target);
+        else if (request.op == OP_POLL && reg.kind == KIND_POLL)
+            armPoll(request.target);
+    }
+}
+
+int IoUringBackend::wait(std::vector<Event>& ready, int timeoutMs) {
+    ready.clear();
+    
+    // buffers handed out by the previous wait() have been consumed by now
+    for (size_t i = 0; i < recycled.size(); i++) {
+        provideBuffer(recycled[i]);
+    }
+    if (!recycled.empty()) {
+        publishBuffers();
+        recycled.clear();
+    }
+    // starved receives and whatever did not fit into the submission queue
+    issueDeferred();
+    
+    bool pending = *cqHead != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+    int result = enter(pending ? 0 : 1, timeoutMs);
+    if (result < 0 && errno != ETIME && errno != EINTR) {
+        return -1;
+    }
+    
+    unsigned int head = *cqHead;
+    unsigned int tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        handleCompletion(cqes[head & cqMask], ready);
+        head++;
+    }
+    __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    
+    if (ready.empty() && result < 0 && errno == EINTR) {
+        return -1;
+    }
+    return ready.size();
+}
+
+void IoUringBackend::handleCompletion(const struct io_uring_cqe& cqe, std::vector<Event>& ready) {
+    int op = (int)(cqe.user_data >> 56);
+    unsigned int generation = (unsigned int)(cqe.user_data >> 32) & 0xffffff;
+    unsigned int target = (unsigned int)cqe.user_data;
+    bool more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+    
+    Event event;
+    event.fd = target;
+    event.events = 0;
+    event.result = cqe.res;
+    event.data = NULL;
+    event.length = 0;
+    
+    if (op == OP_SEND || op == OP_SEND_WAIT) {
+        SendSlot* slot = sendSlots[target];
+        bool current = registration(slot->fd).generation == slot->generation;
+        if (op == OP_SEND && cqe.res == -EAGAIN && current) {
+            waitWritable(target);
+            return;
+        }
+        if (op == OP_SEND_WAIT && cqe.res > 0 && current) {
+            issueSend(target);
+            return;
+        }
+        finishSend(target);
+        if (current) {
+            event.fd = slot->fd;
+            event.events = EVENT_SENT;
+            ready.push_back(event);
+        }
+        return;
+    }
+    if (op == OP_CANCEL) {
+        return;
+    }
+    
+    Registration& reg = registration(target);
+    bool current = (reg.generation & 0xffffff) == generation;
+    
+    if (op == OP_RECV) {
+        if (cqe.flags & IORING_CQE_F_BUFFER) {
+            unsigned short bufferId = cqe.flags >> IORING_CQE_BUFFER_SHIFT;
+            recycled.push_back(bufferId);
+            if (current && cqe.res > 0) {
+                event.events = EVENT_DATA;
+                event.data = bufferMemory + (size_t)bufferId * BUFFER_SIZE;
+                event.length = cqe.res;
+                ready.push_back(event);
+            }
+        } else if (current && cqe.res == -ENOBUFS) {
+            // the buffer ring ran dry: re-armed once wait() has recycled some
+            defer(OP_RECV, reg.generation, target, 0);
+        } else if (current && cqe.res == 0) {
+            event.events = EVENT_EOF;
+            ready.push_back(event);
+        } else if (current && cqe.res < 0 && cqe.res != -ECANCELED) {
+            event.events = EVENT_ERROR;
+            ready.push_back(event);
+        }
+        // the kernel ended the multishot request without an EOF or error: re-arm
+        if (!more && current && reg.kind == KIND_CONNECTION && cqe.res > 0) {
+            armRecv(target);
+        }
+        return;
+    }
+    if (op == OP_ACCEPT) {
+        if (current && cqe.res >= 0) {
+            event.events = EVENT_ACCEPT;
+            ready.push_back(event);
+        }
+        if (!more && current && reg.kind == KIND_LISTENER) {
+            armAccept(target);
+        }
+        return;
+    }
+    if (op == OP_POLL) {
+        if (current && cqe.res > 0) {
+            event.events = EVENT_READ;
+            ready.push_back(event);
+        }
+        if (!more && current && reg.kind == KIND_POLL) {
+            armPoll(target);
+        }
+    }
+}
+
+#endif
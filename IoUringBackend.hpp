@@ -0,0 +1,167 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   IoUringBackend.hpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:42:23 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 01:50:44 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef IOURINGBACKEND_HPP
+#define IOURINGBACKEND_HPP
+
+#include "EventBackend.hpp"
+
+// HAVE_IO_URING is set by the Makefile when the kernel headers are installed;
+// multishot recv (and with it this backend) needs the 6.0 uapi
+#if defined(__linux__) && defined(HAVE_IO_URING)
+# include <linux/io_uring.h>
+# ifdef IORING_RECV_MULTISHOT
+#  define IO_URING_BACKEND 1
+# endif
+#endif
+
+#ifdef IO_URING_BACKEND
+
+#include <sys/socket.h>
+
+// completion based backend on raw io_uring syscalls:
+// - one multishot accept per listener instead of an accept() per wakeup
+// - one multishot recv per client, filled into a kernel-provided buffer ring
+// - sends are queued as SQEs and go out with the next wait(), so every loop
+//   iteration costs a single io_uring_enter
+// - a request that finds the submission queue full waits in the backend and
+//   is queued again by the next wait(), nothing is dropped
+class IoUringBackend : public EventBackend {
+private:
+    enum {
+        KIND_NONE = 0,
+        KIND_POLL,
+        KIND_LISTENER,
+        KIND_CONNECTION
+    };
+    enum {
+        OP_ACCEPT = 1,
+        OP_RECV,
+        OP_POLL,
+        OP_SEND,
+        OP_SEND_WAIT,
+        OP_CANCEL
+    };
+    enum {
+        RING_ENTRIES = 256,
+        COMPLETION_ENTRIES = 4096,
+        BUFFER_COUNT = 256,     // power of two, required by the buffer ring
+        BUFFER_SIZE = 4096,
+        BUFFER_GROUP = 0,
+        MAX_SEND_IOV = 64
+    };
+
+    struct Registration {
+        int kind;
+        unsigned int generation;
+    };
+
+    // sendmsg arguments must stay put until the kernel has consumed them;
+    // the slot holds a reference on every buffer its iovecs point into, so the
+    // bytes outlive the client until the send or its cancellation completes
+    struct SendSlot {
+        int fd;
+        unsigned int generation;
+        bool used;
+        int bufferCount;
+        struct msghdr message;
+        struct iovec iov[MAX_SEND_IOV];
+        SharedBuffer* buffers[MAX_SEND_IOV];
+    };
+
+    // a request that found the submission queue full, issued again by wait()
+    struct Deferred {
+        int op;
+        unsigned int generation;
+        unsigned int target;
+        __u64 cancelTarget;
+    };
+
+    int ringFd;
+    void* ringMemory;
+    size_t ringSize;
+    struct io_uring_sqe* sqes;
+    size_t sqesSize;
+
+    unsigned int* sqHead;
+    unsigned int* sqTail;
+    unsigned int sqMask;
+    unsigned int sqEntries;
+    unsigned int* sqArray;
+    unsigned int sqLocalTail;
+
+    unsigned int* cqHead;
+    unsigned int* cqTail;
+    unsigned int cqMask;
+    struct io_uring_cqe* cqes;
+
+    struct io_uring_buf* bufferRing;
+    size_t bufferRingSize;
+    char* bufferMemory;
+    unsigned short bufferTail;
+    std::vector<unsigned short> recycled;
+
+    std::vector<Registration> registrations;
+    std::vector<SendSlot*> sendSlots;
+    std::vector<size_t> freeSendSlots;
+    std::vector<Deferred> deferred;
+
+    IoUringBackend(const IoUringBackend& other);
+    IoUringBackend& operator=(const IoUringBackend& other);
+
+    void setup();
+    void release();
+    void cancelAll();
+    void checkSupportedOps();
+    void setupBufferRing();
+
+    static __u64 packUserData(int op, unsigned int generation, unsigned int target);
+    Registration& registration(int fd);
+
+    struct io_uring_sqe* nextSqe();
+    int enter(unsigned int minComplete, int timeoutMs);
+    void provideBuffer(unsigned short bufferId);
+    void publishBuffers();
+
+    void armAccept(int fd);
+    void armRecv(int fd);
+    void armPoll(int fd);
+    void cancel(__u64 target);
+    void issueSend(size_t slotIndex);
+    void waitWritable(size_t slotIndex);
+    void finishSend(size_t slotIndex);
+    void defer(int op, unsigned int generation, unsigned int target, __u64 cancelTarget);
+    void issueDeferred();
+
+    void handleCompletion(const struct io_uring_cqe& cqe, std::vector<Event>& ready);
+
+public:
+    IoUringBackend();
+    ~IoUringBackend();
+
+    const char* getName() const;
+    bool isEdgeTriggered() const;
+
+    bool add(int fd, unsigned int events);
+    bool modify(int fd, unsigned int events);
+    void remove(int fd);
+    int wait(std::vector<Event>& ready, int timeoutMs);
+
+    bool addListener(int fd);
+    bool addConnection(int fd);
+    bool completesIo() const;
+    bool submitSend(int fd, const struct iovec* iov, SharedBuffer* const* buffers, int count);
+};
+
+#endif
+
+#endif
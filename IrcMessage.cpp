@@ -0,0 +1,73 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   IrcMessage.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 23:06:10 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 02:17:19 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "IrcMessage.hpp"
+
+IrcMessage::IrcMessage() : paramCount(0), hasTrailing(false) {
+}
+
+// moves pos past the token starting there and returns it
+static StringRef nextToken(const char* line, size_t length, size_t& pos) {
+    size_t begin = pos;
+    while (pos < length && line[pos] != ' ') {
+        pos++;
+    }
+    return StringRef(line + begin, pos - begin);
+}
+
+static void skipSpaces(const char* line, size_t length, size_t& pos) {
+    while (pos < length && line[pos] == ' ') {
+        pos++;
+    }
+}
+
+bool IrcMessage::parse(const char* line, size_t length, IrcMessage& message) {
+    size_t pos = 0;
+    message.tags = StringRef();
+    message.prefix = StringRef();
+    message.paramCount = 0;
+    message.hasTrailing = false;
+    
+    skipSpaces(line, length, pos);
+    if (pos < length && line[pos] == '@') {
+        pos++;
+        message.tags = nextToken(line, length, pos);
+        skipSpaces(line, length, pos);
+    }
+    if (pos < length && line[pos] == ':') {
+        pos++;
+        message.prefix = nextToken(line, length, pos);
+        skipSpaces(line, length, pos);
+    }
+    message.command = nextToken(line, length, pos);
+    if (message.command.empty()) {
+        return false;
+    }
+    
+    while (true) {
+        skipSpaces(line, length, pos);
+        if (pos >= length) {
+            break;
+        }
+        // the trailing parameter, or the 15th one, takes the rest of the line
+        if (line[pos] == ':' || message.paramCount == MAX_PARAMS - 1) {
+            if (line[pos] == ':') {
+                pos++;
+                message.hasTrailing = true;
+            }
+            message.params[message.paramCount++] = StringRef(line + pos, length - pos);
+            break;
+        }
+        message.params[message.paramCount++] = nextToken(line, length, pos);
+    }
+    return true;
+}
@@ -0,0 +1,37 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   IrcMessage.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 23:06:09 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 02:17:19 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef IRCMESSAGE_HPP
+#define IRCMESSAGE_HPP
+
+#include "StringRef.hpp"
+
+// one parsed line: [@tags] [:prefix] COMMAND [params] [:trailing]
+// every field points into the line passed to parse(), nothing is copied or allocated
+struct IrcMessage {
+    // RFC 1459: at most 15 parameters, the last one may contain spaces
+    static const size_t MAX_PARAMS = 15;
+
+    StringRef tags;       // raw IRCv3 tags without the '@', still escaped
+    StringRef prefix;     // without the ':'
+    StringRef command;    // as sent, compare with equalsIgnoreCase()
+    StringRef params[MAX_PARAMS];
+    size_t paramCount;
+    bool hasTrailing;     // the last parameter was introduced by ':'
+
+    IrcMessage();
+
+    // false for lines without a command
+    static bool parse(const char* line, size_t length, IrcMessage& message);
+};
+
+#endif
@@ -0,0 +1,290 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Logger.cpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 01:25:50 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 01:25:50 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Logger.hpp"
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+
+// bounded MPMC ring (Vyukov): a cell is free for the producer at position
+// pos when its sequence equals pos, and holds a record for the consumer
+// when it equals pos + 1
+struct Cell {
+    unsigned long sequence;
+    Logger::Level level;
+    size_t length;
+    char text[Logger::MAX_RECORD];
+};
+
+static Cell cells[Logger::RING_SIZE];
+static unsigned long enqueuePos = 0;       // claimed by producers with a CAS
+static unsigned long dequeuePos = 0;       // log thread only
+static unsigned long droppedRecords = 0;
+
+static int currentLevel = Logger::LEVEL_INFO;
+static unsigned long sampleRate = 1;
+static unsigned long sampleCounter = 0;
+
+static pthread_t thread;
+static int wakePipe[2] = { -1, -1 };
+static int wakePending = 0;
+static int running = 0;
+static int stopping = 0;
+
+// the log thread's batches, one per output
+static const size_t BATCH_SIZE = 65536;
+static char outBatch[BATCH_SIZE];
+static size_t outLength = 0;
+static char errBatch[BATCH_SIZE];
+static size_t errLength = 0;
+
+static void writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        data += written;
+        length -= written;
+    }
+}
+
+static void flushBatches() {
+    writeAll(STDOUT_FILENO, outBatch, outLength);
+    outLength = 0;
+    writeAll(STDERR_FILENO, errBatch, errLength);
+    errLength = 0;
+}
+
+static void batchRecord(Logger::Level level, const char* text, size_t length) {
+    bool toErr = level <= Logger::LEVEL_WARN;
+    char* batch = toErr ? errBatch : outBatch;
+    size_t& used = toErr ? errLength : outLength;
+    if (used + length + 1 > BATCH_SIZE)
+        flushBatches();
+    std::memcpy(batch + used, text, length);
+    batch[used + length] = '\n';
+    used += length + 1;
+}
+
+// nothing is running to batch for: one write per record
+static void writeRecord(Logger::Level level, const char* text, size_t length) {
+    char line[Logger::MAX_RECORD + 1];
+    std::memcpy(line, text, length);
+    line[length] = '\n';
+    writeAll(level <= Logger::LEVEL_WARN ? STDERR_FILENO : STDOUT_FILENO, line, length + 1);
+}
+
+// same scheme as Reactor::wakeup: only the first producer after a drain writes
+static void wakeup() {
+    if (__atomic_exchange_n(&wakePending, 1, __ATOMIC_SEQ_CST) == 0) {
+        char byte = 1;
+        ssize_t written = write(wakePipe[1], &byte, 1);
+        (void)written;
+    }
+}
+
+static void drainRing() {
+    while (true) {
+        Cell& cell = cells[dequeuePos & (Logger::RING_SIZE - 1)];
+        if (__atomic_load_n(&cell.sequence, __ATOMIC_ACQUIRE) != dequeuePos + 1)
+            break;
+        batchRecord(cell.level, cell.text, cell.length);
+        __atomic_store_n(&cell.sequence, dequeuePos + Logger::RING_SIZE, __ATOMIC_RELEASE);
+        dequeuePos++;
+    }
+    unsigned long dropped = __atomic_exchange_n(&droppedRecords, 0, __ATOMIC_RELAXED);
+    if (dropped) {
+        // goes through the ring like any other record and wakes the thread again
+        Logger::Record note(Logger::LEVEL_WARN);
+        note << "Log ring full, dropped " << dropped << " records";
+    }
+}
+
+static void* logThread(void*) {
+    char buffer[64];
+    while (true) {
+        ssize_t received = read(wakePipe[0], buffer, sizeof(buffer));
+        if (received < 0 && errno != EINTR)
+            break;
+        // re-arm before draining so anything logged from now on wakes us again
+        __atomic_store_n(&wakePending, 0, __ATOMIC_SEQ_CST);
+        drainRing();
+        flushBatches();
+        if (__atomic_load_n(&stopping, __ATOMIC_ACQUIRE))
+            break;
+    }
+    return NULL;
+}
+
+bool Logger::parseLevel(const std::string& name, Level& level) {
+    static const char* const names[] = { "error", "warn", "info", "debug" };
+    for (int i = LEVEL_ERROR; i <= LEVEL_DEBUG; i++) {
+        if (name == names[i]) {
+            level = static_cast<Level>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Logger::setLevel(Level level) {
+    __atomic_store_n(&currentLevel, static_cast<int>(level), __ATOMIC_RELAXED);
+}
+
+void Logger::setSampleRate(unsigned long rate) {
+    __atomic_store_n(&sampleRate, rate ? rate : 1, __ATOMIC_RELAXED);
+}
+
+bool Logger::enabled(Level level) {
+    if (static_cast<int>(level) > __atomic_load_n(&currentLevel, __ATOMIC_RELAXED))
+        return false;
+    unsigned long rate = __atomic_load_n(&sampleRate, __ATOMIC_RELAXED);
+    if (level < LEVEL_DEBUG || rate == 1)
+        return true;
+    return __atomic_fetch_add(&sampleCounter, 1, __ATOMIC_RELAXED) % rate == 0;
+}
+
+// the log thread must not take SIGINT/SIGTERM away from the main thread
+bool Logger::start() {
+    if (running)
+        return true;
+    if (pipe(wakePipe) < 0)
+        return false;
+    fcntl(wakePipe[1], F_SETFL, O_NONBLOCK);
+    for (size_t i = 0; i < RING_SIZE; i++)
+        cells[i].sequence = i;
+    enqueuePos = 0;
+    dequeuePos = 0;
+    stopping = 0;
+    wakePending = 0;
+    
+    sigset_t blocked;
+    sigset_t previous;
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGINT);
+    sigaddset(&blocked, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+    int result = pthread_create(&thread, NULL, &logThread, NULL);
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+    if (result != 0) {
+        close(wakePipe[0]);
+        close(wakePipe[1]);
+        return false;
+    }
+    __atomic_store_n(&running, 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+void Logger::stop() {
+    if (!running)
+        return;
+    __atomic_store_n(&stopping, 1, __ATOMIC_RELEASE);
+    char byte = 1;
+    ssize_t written = write(wakePipe[1], &byte, 1);
+    (void)written;
+    pthread_join(thread, NULL);
+    __atomic_store_n(&running, 0, __ATOMIC_RELEASE);
+    // records that raced with the shutdown
+    drainRing();
+    flushBatches();
+    close(wakePipe[0]);
+    close(wakePipe[1]);
+}
+
+void Logger::submit(Level level, const char* text, size_t length) {
+    if (!__atomic_load_n(&running, __ATOMIC_ACQUIRE)) {
+        writeRecord(level, text, length);
+        return;
+    }
+    unsigned long pos = __atomic_load_n(&enqueuePos, __ATOMIC_RELAXED);
+    Cell* cell;
+    while (true) {
+        cell = &cells[pos & (RING_SIZE - 1)];
+        unsigned long sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        long diff = static_cast<long>(sequence - pos);
+        if (diff == 0) {
+            // on failure pos is reloaded with the current position
+            if (__atomic_compare_exchange_n(&enqueuePos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        } else if (diff < 0) {
+            __atomic_add_fetch(&droppedRecords, 1, __ATOMIC_RELAXED);
+            return;
+        } else {
+            pos = __atomic_load_n(&enqueuePos, __ATOMIC_RELAXED);
+        }
+    }
+    cell->level = level;
+    cell->length = length;
+    std::memcpy(cell->text, text, length);
+    __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+    wakeup();
+}
+
+Logger::Record::Record(Level level)
+    : level(level), length(0) {
+}
+
+Logger::Record::~Record() {
+    Logger::submit(level, text, length);
+}
+
+Logger::Record& Logger::Record::operator<<(const StringRef& value) {
+    size_t count = value.length;
+    if (count > MAX_RECORD - length)
+        count = MAX_RECORD - length;
+    std::memcpy(text + length, value.data, count);
+    length += count;
+    return *this;
+}
+
+Logger::Record& Logger::Record::operator<<(const char* value) {
+    return *this << StringRef(value);
+}
+
+Logger::Record& Logger::Record::operator<<(char c) {
+    if (length < MAX_RECORD)
+        text[length++] = c;
+    return *this;
+}
+
+Logger::Record& Logger::Record::operator<<(int value) {
+    return *this << static_cast<long>(value);
+}
+
+Logger::Record& Logger::Record::operator<<(unsigned int value) {
+    return *this << static_cast<unsigned long>(value);
+}
+
+Logger::Record& Logger::Record::operator<<(long value) {
+    if (value < 0) {
+        *this << '-';
+        return *this << (0UL - static_cast<unsigned long>(value));
+    }
+    return *this << static_cast<unsigned long>(value);
+}
+
+Logger::Record& Logger::Record::operator<<(unsigned long value) {
+    char digits[24];
+    size_t count = 0;
+    do {
+        digits[sizeof(digits) - 1 - count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value);
+    return *this << StringRef(digits + sizeof(digits) - count, count);
+}
@@ -0,0 +1,82 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Logger.hpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 01:25:50 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 01:25:50 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <cstddef>
+#include <string>
+#include "StringRef.hpp"
+
+// asynchronous log: a record is formatted on the caller's stack and copied
+// into a fixed lock-free ring, a background thread writes the records out.
+// when the ring is full the record is dropped and counted instead of
+// waiting, so an event loop never blocks on the terminal or a log pipe.
+// errors and warnings go to stderr, the rest to stdout.
+class Logger {
+public:
+    enum Level {
+        LEVEL_ERROR,
+        LEVEL_WARN,
+        LEVEL_INFO,
+        LEVEL_DEBUG     // per-line traffic
+    };
+
+    // longer records are cut
+    static const size_t MAX_RECORD = 256;
+    // records in flight, a power of two
+    static const size_t RING_SIZE = 1024;
+
+    // one line, handed to the ring when it goes out of scope; use LOG()
+    class Record {
+    private:
+        Level level;
+        size_t length;
+        char text[MAX_RECORD];
+
+        Record(const Record& other);
+        Record& operator=(const Record& other);
+
+    public:
+        explicit Record(Level level);
+        ~Record();
+
+        Record& operator<<(const StringRef& text);
+        Record& operator<<(const char* text);
+        Record& operator<<(char c);
+        Record& operator<<(int value);
+        Record& operator<<(unsigned int value);
+        Record& operator<<(long value);
+        Record& operator<<(unsigned long value);
+    };
+
+    static bool parseLevel(const std::string& name, Level& level);
+    // may be changed while running; sampleRate keeps one debug record in that many
+    static void setLevel(Level level);
+    static void setSampleRate(unsigned long sampleRate);
+    // level check, plus sampling for debug records
+    static bool enabled(Level level);
+
+    // before start() and after stop() records are written synchronously
+    static bool start();
+    // writes out what is still queued and joins the thread
+    static void stop();
+
+    static void submit(Level level, const char* text, size_t length);
+};
+
+// LOG(INFO) << "Client " << fd << " removed";
+// the arguments are not evaluated when the level is off
+#define LOG(level) \
+    if (!Logger::enabled(Logger::LEVEL_##level)) {} else Logger::Record(Logger::LEVEL_##level)
+
+#endif
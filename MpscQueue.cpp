@@ -0,0 +1,56 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MpscQueue.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:34:49 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/16 22:34:49 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "MpscQueue.hpp"
+
+MpscQueue::MpscQueue() : head(&stub), tail(&stub) {
+}
+
+MpscQueue::~MpscQueue() {
+}
+
+void MpscQueue::push(Node* node) {
+    __atomic_store_n(&node->next, (Node*)NULL, __ATOMIC_RELAXED);
+    Node* prev = __atomic_exchange_n(&head, node, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+}
+
+MpscQueue::Node* MpscQueue::pop() {
+    Node* first = tail;
+    Node* next = __atomic_load_n(&first->next, __ATOMIC_ACQUIRE);
+    
+    // skip the stub node
+    if (first == &stub) {
+        if (next == NULL)
+            return NULL;
+        tail = next;
+        first = next;
+        next = __atomic_load_n(&next->next, __ATOMIC_ACQUIRE);
+    }
+    if (next != NULL) {
+        tail = next;
+        return first;
+    }
+    
+    // first looks like the last node, but a producer may have swapped head already
+    if (first != __atomic_load_n(&head, __ATOMIC_ACQUIRE))
+        return NULL;
+    
+    // put the stub back behind the last node so it can be handed out
+    push(&stub);
+    next = __atomic_load_n(&first->next, __ATOMIC_ACQUIRE);
+    if (next != NULL) {
+        tail = next;
+        return first;
+    }
+    return NULL;
+}
@@ -0,0 +1,46 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MpscQueue.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:34:49 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/16 22:34:49 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef MPSCQUEUE_HPP
+#define MPSCQUEUE_HPP
+
+#include <cstddef>
+
+// intrusive lock-free multi-producer/single-consumer queue (Vyukov).
+// push() may be called from any thread, pop() only from the owning one.
+class MpscQueue {
+public:
+    struct Node {
+        Node* next;
+        Node() : next(NULL) {}
+        virtual ~Node() {}
+    };
+
+private:
+    Node* head;     // last pushed node, swapped by producers
+    Node* tail;     // next node to pop, consumer only
+    Node stub;
+
+    MpscQueue(const MpscQueue& other);
+    MpscQueue& operator=(const MpscQueue& other);
+
+public:
+    MpscQueue();
+    ~MpscQueue();
+
+    void push(Node* node);
+    // returns NULL when empty or when a producer is halfway through push();
+    // in that case the producer's wakeup will trigger another drain
+    Node* pop();
+};
+
+#endif
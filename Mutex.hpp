@@ -0,0 +1,46 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Mutex.hpp                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:34:49 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/16 22:34:49 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef MUTEX_HPP
+#define MUTEX_HPP
+
+#include <pthread.h>
+
+class Mutex {
+private:
+    pthread_mutex_t handle;
+
+    Mutex(const Mutex& other);
+    Mutex& operator=(const Mutex& other);
+
+public:
+    Mutex() { pthread_mutex_init(&handle, NULL); }
+    ~Mutex() { pthread_mutex_destroy(&handle); }
+
+    void lock() { pthread_mutex_lock(&handle); }
+    void unlock() { pthread_mutex_unlock(&handle); }
+};
+
+// holds the mutex for the lifetime of the guard
+class ScopedLock {
+private:
+    Mutex& mutex;
+
+    ScopedLock(const ScopedLock& other);
+    ScopedLock& operator=(const ScopedLock& other);
+
+public:
+    explicit ScopedLock(Mutex& m) : mutex(m) { mutex.lock(); }
+    ~ScopedLock() { mutex.unlock(); }
+};
+
+#endif
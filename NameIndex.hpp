@@ -0,0 +1,152 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   NameIndex.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 23:20:50 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 00:53:00 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef NAMEINDEX_HPP
+#define NAMEINDEX_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "CaseMap.hpp"
+#include "StringRef.hpp"
+
+// hash index from a nick or channel name to its object, case-insensitive
+// under CaseMap. Keys are stored folded; lookups fold the query on the fly,
+// so finding a name allocates nothing.
+template <typename T>
+class NameIndex {
+private:
+    struct Node {
+        std::string key;    // folded
+        size_t hash;
+        T* value;
+        Node* next;
+    };
+
+    std::vector<Node*> buckets;   // power-of-two count
+    size_t count;
+
+    // FNV-1a over the folded bytes
+    static size_t hashName(const StringRef& name) {
+        size_t hash = 2166136261u;
+        for (size_t i = 0; i < name.size(); i++) {
+            hash ^= CaseMap::fold(name[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    static bool matches(const Node* node, size_t hash, const StringRef& name) {
+        if (node->hash != hash || node->key.length() != name.size())
+            return false;
+        for (size_t i = 0; i < name.size(); i++) {
+            if (static_cast<unsigned char>(node->key[i]) != CaseMap::fold(name[i]))
+                return false;
+        }
+        return true;
+    }
+
+    void rehash(size_t bucketCount) {
+        std::vector<Node*> resized(bucketCount, static_cast<Node*>(NULL));
+        for (size_t i = 0; i < buckets.size(); i++) {
+            Node* node = buckets[i];
+            while (node) {
+                Node* next = node->next;
+                size_t slot = node->hash & (bucketCount - 1);
+                node->next = resized[slot];
+                resized[slot] = node;
+                node = next;
+            }
+        }
+        buckets.swap(resized);
+    }
+
+    NameIndex(const NameIndex& other);
+    NameIndex& operator=(const NameIndex& other);
+
+public:
+    NameIndex() : buckets(16, static_cast<Node*>(NULL)), count(0) {}
+
+    ~NameIndex() {
+        clear();
+    }
+
+    size_t size() const { return count; }
+
+    T* find(const StringRef& name) const {
+        size_t hash = hashName(name);
+        for (Node* node = buckets[hash & (buckets.size() - 1)]; node; node = node->next) {
+            if (matches(node, hash, name))
+                return node->value;
+        }
+        return NULL;
+    }
+
+    // false when the folded name is already taken
+    bool insert(const std::string& name, T* value) {
+        if (find(name))
+            return false;
+        if (count >= buckets.size())
+            rehash(buckets.size() * 2);
+        Node* node = new Node;
+        node->key = CaseMap::fold(name);
+        node->hash = hashName(name);
+        node->value = value;
+        size_t slot = node->hash & (buckets.size() - 1);
+        node->next = buckets[slot];
+        buckets[slot] = node;
+        count++;
+        return true;
+    }
+
+    // removes the entry only while it still maps to value
+    bool erase(const std::string& name, T* value) {
+        size_t hash = hashName(name);
+        Node** link = &buckets[hash & (buckets.size() - 1)];
+        while (*link) {
+            Node* node = *link;
+            if (matches(node, hash, name)) {
+                if (node->value != value)
+                    return false;
+                *link = node->next;
+                delete node;
+                count--;
+                return true;
+            }
+            link = &node->next;
+        }
+        return false;
+    }
+
+    // every indexed object, in no particular order
+    void collect(std::vector<T*>& out) const {
+        for (size_t i = 0; i < buckets.size(); i++) {
+            for (Node* node = buckets[i]; node; node = node->next)
+                out.push_back(node->value);
+        }
+    }
+
+    void clear() {
+        for (size_t i = 0; i < buckets.size(); i++) {
+            Node* node = buckets[i];
+            while (node) {
+                Node* next = node->next;
+                delete node;
+                node = next;
+            }
+            buckets[i] = NULL;
+        }
+        count = 0;
+    }
+};
+
+#endif
@@ -0,0 +1,110 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Numerics.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 00:54:14 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 00:54:14 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Numerics.hpp"
+#include <cstring>
+
+// text after the target; every '%' is replaced by the next argument
+struct NumericTemplate {
+    const char* code;
+    const char* text;
+    size_t length;
+};
+
+#define NUMERIC(code, text) { code, text, sizeof(text) - 1 }
+
+// RFC 1459 / 2812 layouts, same order as the Numeric enum
+static const NumericTemplate numericTable[] = {
+    NUMERIC("001", ":Welcome to the Internet Relay Network %"),
+    NUMERIC("002", ":Your host is %, running version %"),
+    NUMERIC("003", ":This server was created %"),
+    NUMERIC("004", "% % o itklov"),
+    NUMERIC("211", "%"),
+    NUMERIC("212", "% % % 0"),
+    NUMERIC("219", "% :End of STATS report"),
+    NUMERIC("249", "% :%"),
+    NUMERIC("324", "% %"),
+    NUMERIC("331", "% :No topic is set"),
+    NUMERIC("332", "% :%"),
+    NUMERIC("341", "% %"),
+    NUMERIC("353", "= % :%"),
+    NUMERIC("366", "% :End of /NAMES list"),
+    NUMERIC("372", ":- %"),
+    NUMERIC("375", ":- % Message of the day -"),
+    NUMERIC("376", ":End of /MOTD command"),
+    NUMERIC("401", "% :No such nick/channel"),
+    NUMERIC("403", "% :No such channel"),
+    NUMERIC("404", "% :Cannot send to channel"),
+    NUMERIC("409", ":No origin specified"),
+    NUMERIC("411", ":No recipient given (%)"),
+    NUMERIC("412", ":No text to send"),
+    NUMERIC("417", ":Input line was too long"),
+    NUMERIC("421", "% :Unknown command"),
+    NUMERIC("431", ":No nickname given"),
+    NUMERIC("432", "% :Erroneous nickname"),
+    NUMERIC("433", "% :Nickname is already in use"),
+    NUMERIC("441", "% % :They aren't on that channel"),
+    NUMERIC("442", "% :You're not on that channel"),
+    NUMERIC("443", "% % :is already on channel"),
+    NUMERIC("451", ":You have not registered"),
+    NUMERIC("461", "% :Not enough parameters"),
+    NUMERIC("462", ":You may not reregister"),
+    NUMERIC("464", ":Password incorrect"),
+    NUMERIC("471", "% :Cannot join channel (+l)"),
+    NUMERIC("472", "% :is unknown mode char to me"),
+    NUMERIC("473", "% :Cannot join channel (+i)"),
+    NUMERIC("475", "% :Cannot join channel (+k)"),
+    NUMERIC("482", "% :You're not channel operator"),
+    NUMERIC("502", ":Cannot change mode for other users")
+};
+
+#undef NUMERIC
+
+// a missing or extra template breaks the build instead of shifting every reply
+typedef char numericTableMatchesEnum[sizeof(numericTable) / sizeof(numericTable[0]) == NUMERIC_COUNT ? 1 : -1];
+
+int NumericReply::format(Numeric numeric, const StringRef& server, const StringRef& target,
+                         const StringRef* args, StringRef* pieces, size_t& total) {
+    const NumericTemplate& entry = numericTable[numeric];
+    int count = 0;
+    pieces[count++] = StringRef(":", 1);
+    pieces[count++] = server;
+    pieces[count++] = StringRef(" ", 1);
+    pieces[count++] = StringRef(entry.code, 3);
+    pieces[count++] = StringRef(" ", 1);
+    pieces[count++] = target;
+    
+    // the target is followed by a space unless the text is empty
+    const char* text = entry.text;
+    size_t remaining = entry.length;
+    if (remaining > 0) {
+        pieces[count++] = StringRef(" ", 1);
+    }
+    int used = 0;
+    while (remaining > 0) {
+        const char* marker = static_cast<const char*>(std::memchr(text, '%', remaining));
+        if (!marker || used == MAX_ARGS) {
+            pieces[count++] = StringRef(text, remaining);
+            break;
+        }
+        if (marker > text)
+            pieces[count++] = StringRef(text, marker - text);
+        pieces[count++] = args[used++];
+        remaining -= marker + 1 - text;
+        text = marker + 1;
+    }
+    
+    total = 0;
+    for (int i = 0; i < count; i++)
+        total += pieces[i].length;
+    return count;
+}
@@ -0,0 +1,80 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Numerics.hpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 00:54:14 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 00:54:14 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef NUMERICS_HPP
+#define NUMERICS_HPP
+
+#include <cstddef>
+#include "StringRef.hpp"
+
+// every numeric reply the server sends, in the order of the template table
+// in Numerics.cpp
+enum Numeric {
+    RPL_WELCOME,
+    RPL_YOURHOST,
+    RPL_CREATED,
+    RPL_MYINFO,
+    RPL_STATSLINKINFO,
+    RPL_STATSCOMMANDS,
+    RPL_ENDOFSTATS,
+    RPL_STATSDEBUG,
+    RPL_CHANNELMODEIS,
+    RPL_NOTOPIC,
+    RPL_TOPIC,
+    RPL_INVITING,
+    RPL_NAMREPLY,
+    RPL_ENDOFNAMES,
+    RPL_MOTD,
+    RPL_MOTDSTART,
+    RPL_ENDOFMOTD,
+    ERR_NOSUCHNICK,
+    ERR_NOSUCHCHANNEL,
+    ERR_CANNOTSENDTOCHAN,
+    ERR_NOORIGIN,
+    ERR_NORECIPIENT,
+    ERR_NOTEXTTOSEND,
+    ERR_INPUTTOOLONG,
+    ERR_UNKNOWNCOMMAND,
+    ERR_NONICKNAMEGIVEN,
+    ERR_ERRONEUSNICKNAME,
+    ERR_NICKNAMEINUSE,
+    ERR_USERNOTINCHANNEL,
+    ERR_NOTONCHANNEL,
+    ERR_USERONCHANNEL,
+    ERR_NOTREGISTERED,
+    ERR_NEEDMOREPARAMS,
+    ERR_ALREADYREGISTRED,
+    ERR_PASSWDMISMATCH,
+    ERR_CHANNELISFULL,
+    ERR_UNKNOWNMODE,
+    ERR_INVITEONLYCHAN,
+    ERR_BADCHANNELKEY,
+    ERR_CHANOPRIVSNEEDED,
+    ERR_USERSDONTMATCH,
+    NUMERIC_COUNT
+};
+
+// lays out ":<server> <code> <target> <text>" as a list of pieces, the
+// template text split around its arguments. nothing is copied; the caller
+// appends the pieces in one go, their total length known up front
+class NumericReply {
+public:
+    static const int MAX_ARGS = 3;
+    // prefix, code and target with their separators, then a text run
+    // before every argument and one after the last
+    static const int MAX_PIECES = 7 + 2 * MAX_ARGS + 1;
+
+    static int format(Numeric numeric, const StringRef& server, const StringRef& target,
+                      const StringRef* args, StringRef* pieces, size_t& total);
+};
+
+#endif
@@ -0,0 +1,166 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   OutputQueue.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:52:06 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 01:50:44 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "OutputQueue.hpp"
+#include "SharedBuffer.hpp"
+
+// room for a run of short replies, e.g. the whole welcome burst
+static const size_t CHUNK_SIZE = 1000;
+
+OutputQueue::OutputQueue()
+    : slots(inlineSlots),
+      capacity(INLINE_SLOTS),
+      head(0),
+      count(0),
+      headOffset(0),
+      queuedBytes(0) {
+}
+
+OutputQueue::~OutputQueue() {
+    clear();
+}
+
+SharedBuffer* OutputQueue::slot(size_t index) const {
+    return slots[(head + index) & (capacity - 1)];
+}
+
+// capacity stays a power of two so the ring index is a mask
+void OutputQueue::grow() {
+    size_t newCapacity = capacity * 2;
+    SharedBuffer** newSlots = new SharedBuffer*[newCapacity];
+    for (size_t i = 0; i < count; i++) {
+        newSlots[i] = slot(i);
+    }
+    if (slots != inlineSlots) {
+        delete[] slots;
+    }
+    slots = newSlots;
+    capacity = newCapacity;
+    head = 0;
+}
+
+void OutputQueue::push(SharedBuffer* buffer) {
+    if (count == capacity) {
+        grow();
+    }
+    buffer->retain();
+    slots[(head + count) & (capacity - 1)] = buffer;
+    count++;
+    queuedBytes += buffer->size();
+}
+
+void OutputQueue::appendLine(const StringRef& message) {
+    if (count > 0) {
+        SharedBuffer* tail = slot(count - 1);
+        size_t before = tail->size();
+        if (!tail->isShared() && tail->appendLine(message)) {
+            queuedBytes += tail->size() - before;
+            return;
+        }
+    }
+    SharedBuffer* chunk = SharedBuffer::withCapacity(message.size() + 2 > CHUNK_SIZE 
+                                                     ? message.size() + 2 : CHUNK_SIZE);
+    chunk->appendLine(message);
+    push(chunk);
+    chunk->release();
+}
+
+// same as appendLine, for a line gathered from pieces of known total length
+void OutputQueue::appendPieces(const StringRef* pieces, int pieceCount, size_t total) {
+    if (count > 0) {
+        SharedBuffer* tail = slot(count - 1);
+        if (!tail->isShared() && tail->appendPieces(pieces, pieceCount, total)) {
+            queuedBytes += total + 2;
+            return;
+        }
+    }
+    SharedBuffer* chunk = SharedBuffer::withCapacity(total + 2 > CHUNK_SIZE ? total + 2 : CHUNK_SIZE);
+    chunk->appendPieces(pieces, pieceCount, total);
+    push(chunk);
+    chunk->release();
+}
+
+int OutputQueue::fillIov(struct iovec* iov, int maxCount) const {
+    return fillIov(iov, NULL, maxCount);
+}
+
+int OutputQueue::fillIov(struct iovec* iov, SharedBuffer** buffers, int maxCount) const {
+    int filled = 0;
+    for (size_t i = 0; i < count && filled < maxCount; i++) {
+        SharedBuffer* buffer = slot(i);
+        size_t offset = (i == 0) ? headOffset : 0;
+        iov[filled].iov_base = const_cast<char*>(buffer->data() + offset);
+        iov[filled].iov_len = buffer->size() - offset;
+        if (buffers) {
+            buffers[filled] = buffer;
+        }
+        filled++;
+    }
+    return filled;
+}
+
+void OutputQueue::consume(size_t bytes) {
+    queuedBytes -= bytes < queuedBytes ? bytes : queuedBytes;
+    while (bytes > 0 && count > 0) {
+        SharedBuffer* front = slots[head];
+        size_t remaining = front->size() - headOffset;
+        if (bytes < remaining) {
+            headOffset += bytes;
+            return;
+        }
+        bytes -= remaining;
+        headOffset = 0;
+        head = (head + 1) & (capacity - 1);
+        count--;
+        front->release();
+    }
+    if (count == 0) {
+        clear();
+    }
+}
+
+// releases every reference and gives a grown ring back
+void OutputQueue::clear() {
+    for (size_t i = 0; i < count; i++) {
+        slot(i)->release();
+    }
+    if (slots != inlineSlots) {
+        delete[] slots;
+        slots = inlineSlots;
+        capacity = INLINE_SLOTS;
+    }
+    head = 0;
+    count = 0;
+    headOffset = 0;
+    queuedBytes = 0;
+}
+
+// a partly sent front buffer stays, so the peer never sees a cut line
+void OutputQueue::dropUnsent() {
+    if (headOffset == 0) {
+        clear();
+        return;
+    }
+    for (size_t i = 1; i < count; i++) {
+        slot(i)->release();
+    }
+    count = 1;
+    queuedBytes = slots[head]->size() - headOffset;
+}
+
+bool OutputQueue::empty() const {
+    return count == 0;
+}
+
+size_t OutputQueue::bytes() const {
+    return queuedBytes;
+}
@@ -0,0 +1,68 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   OutputQueue.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:52:06 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 01:50:44 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef OUTPUTQUEUE_HPP
+#define OUTPUTQUEUE_HPP
+
+#include <string>
+#include <cstddef>
+#include <sys/uio.h>
+#include "StringRef.hpp"
+
+class SharedBuffer;
+
+// per-client output: a ring of buffer references plus a cursor into the front one.
+// sent bytes are dropped by moving the cursor, short replies are appended to the
+// tail chunk while nobody else holds it. a drained queue keeps no heap memory.
+class OutputQueue {
+private:
+    enum { INLINE_SLOTS = 8 };
+
+    SharedBuffer* inlineSlots[INLINE_SLOTS];
+    SharedBuffer** slots;
+    size_t capacity;
+    size_t head;
+    size_t count;
+    size_t headOffset;
+    size_t queuedBytes;
+
+    void grow();
+    SharedBuffer* slot(size_t index) const;
+
+    OutputQueue(const OutputQueue& other);
+    OutputQueue& operator=(const OutputQueue& other);
+
+public:
+    OutputQueue();
+    ~OutputQueue();
+
+    // queues a reference to a line that may be shared with other clients
+    void push(SharedBuffer* buffer);
+    // copies a line for this client only
+    void appendLine(const StringRef& message);
+    void appendPieces(const StringRef* pieces, int pieceCount, size_t total);
+
+    // points the iovecs at the unsent bytes, front first
+    int fillIov(struct iovec* iov, int maxCount) const;
+    // same, and names the buffer behind each iovec
+    int fillIov(struct iovec* iov, SharedBuffer** buffers, int maxCount) const;
+    // drops bytes the kernel has taken
+    void consume(size_t bytes);
+    void clear();
+    // drops every buffer that has not started going out
+    void dropUnsent();
+
+    bool empty() const;
+    size_t bytes() const;
+};
+
+#endif
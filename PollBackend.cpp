@@ -0,0 +1,107 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   PollBackend.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:29:30 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/16 22:48:34 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "PollBackend.hpp"
+
+PollBackend::PollBackend() {
+}
+
+PollBackend::~PollBackend() {
+}
+
+const char* PollBackend::getName() const {
+    return "poll";
+}
+
+bool PollBackend::isEdgeTriggered() const {
+    return false;
+}
+
+short PollBackend::toPollEvents(unsigned int events) {
+    short result = 0;
+    if (events & EVENT_READ)
+        result |= POLLIN;
+    if (events & EVENT_WRITE)
+        result |= POLLOUT;
+    return result;
+}
+
+bool PollBackend::add(int fd, unsigned int events) {
+    if (fd < 0)
+        return false;
+    if ((size_t)fd >= slotByFd.size()) {
+        size_t newSize = slotByFd.empty() ? 64 : slotByFd.size();
+        while (newSize <= (size_t)fd)
+            newSize *= 2;
+        slotByFd.resize(newSize, -1);
+    }
+    if (slotByFd[fd] != -1)
+        return false;
+    
+    struct pollfd entry;
+    entry.fd = fd;
+    entry.events = toPollEvents(events);
+    entry.revents = 0;
+    slotByFd[fd] = pollFds.size();
+    pollFds.push_back(entry);
+    return true;
+}
+
+bool PollBackend::modify(int fd, unsigned int events) {
+    if (fd < 0 || (size_t)fd >= slotByFd.size() || slotByFd[fd] == -1)
+        return false;
+    pollFds[slotByFd[fd]].events = toPollEvents(events);
+    return true;
+}
+
+// swap-remove: the last entry takes over the freed slot
+void PollBackend::remove(int fd) {
+    if (fd < 0 || (size_t)fd >= slotByFd.size() || slotByFd[fd] == -1)
+        return;
+    int slot = slotByFd[fd];
+    pollFds[slot] = pollFds.back();
+    slotByFd[pollFds[slot].fd] = slot;
+    pollFds.pop_back();
+    slotByFd[fd] = -1;
+}
+
+int PollBackend::wait(std::vector<Event>& ready, int timeoutMs) {
+    ready.clear();
+    int pollCount = poll(&pollFds[0], pollFds.size(), timeoutMs);
+    if (pollCount <= 0) {
+        return pollCount;
+    }
+    
+    // collect every entry with reported events
+    for (size_t i = 0; i < pollFds.size() && (int)ready.size() < pollCount; i++) {
+        short revents = pollFds[i].revents;
+        if (revents == 0) {
+            continue;
+        }
+        Event event;
+        event.fd = pollFds[i].fd;
+        event.events = 0;
+        event.result = 0;
+        event.data = NULL;
+        event.length = 0;
+        if (revents & POLLIN)
+            event.events |= EVENT_READ;
+        if (revents & POLLOUT)
+            event.events |= EVENT_WRITE;
+        if (revents & POLLHUP)
+            event.events |= EVENT_HANGUP;
+        if (revents & (POLLERR | POLLNVAL))
+            event.events |= EVENT_ERROR;
+        ready.push_back(event);
+    }
+    return ready.size();
+}
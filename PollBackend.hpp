@@ -0,0 +1,41 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   PollBackend.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:29:30 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/16 22:31:52 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef POLLBACKEND_HPP
+#define POLLBACKEND_HPP
+
+#include "EventBackend.hpp"
+#include <poll.h>
+
+// level-triggered fallback: every wait() hands the whole pollfd array to the kernel.
+// slotByFd maps an fd to its pollfd entry so add/modify/remove stay O(1)
+class PollBackend : public EventBackend {
+private:
+    std::vector<struct pollfd> pollFds;
+    std::vector<int> slotByFd;
+
+    static short toPollEvents(unsigned int events);
+
+public:
+    PollBackend();
+    ~PollBackend();
+
+    const char* getName() const;
+    bool isEdgeTriggered() const;
+
+    bool add(int fd, unsigned int events);
+    bool modify(int fd, unsigned int events);
+    void remove(int fd);
+    int wait(std::vector<Event>& ready, int timeoutMs);
+};
+
+#endif
@@ -0,0 +1,73 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   PoolAllocator.hpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 00:27:47 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 00:27:47 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef POOLALLOCATOR_HPP
+#define POOLALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+#include "SlabAllocator.hpp"
+
+// standard allocator that takes container storage from the slab size
+// classes, e.g. std::vector<T, PoolAllocator<T> >. stateless, so any two
+// instances can free each other's memory
+template <typename T>
+class PoolAllocator {
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind {
+        typedef PoolAllocator<U> other;
+    };
+
+    PoolAllocator() {}
+    PoolAllocator(const PoolAllocator&) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    pointer address(reference value) const { return &value; }
+    const_pointer address(const_reference value) const { return &value; }
+
+    pointer allocate(size_type count, const void* = 0) {
+        if (count > max_size())
+            throw std::bad_alloc();
+        return static_cast<pointer>(SlabAllocator::allocateSized(count * sizeof(T)));
+    }
+
+    void deallocate(pointer memory, size_type count) {
+        SlabAllocator::deallocateSized(memory, count * sizeof(T));
+    }
+
+    size_type max_size() const { return static_cast<size_t>(-1) / sizeof(T); }
+
+    void construct(pointer memory, const T& value) { new (memory) T(value); }
+    void destroy(pointer memory) { memory->~T(); }
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) {
+    return false;
+}
+
+#endif
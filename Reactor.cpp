@@ -0,0 +1,309 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Reactor.cpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:34:49 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 02:44:23 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "Reactor.hpp"
+#include "Client.hpp"
+#include "SharedBuffer.hpp"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+
+static __thread Reactor* currentReactor = NULL;
+
+Reactor::Reactor(Server* owner, int id)
+    : owner(owner),
+      id(id),
+      listenSocket(-1),
+      wakePending(0),
+      backend(NULL) {
+    wakePipe[0] = -1;
+    wakePipe[1] = -1;
+}
+
+Reactor::~Reactor() {
+    MpscQueue::Node* node;
+    while ((node = inbox.pop()) != NULL) {
+        delete node;
+    }
+    delete backend;
+    if (listenSocket != -1)
+        close(listenSocket);
+    if (wakePipe[0] != -1)
+        close(wakePipe[0]);
+    if (wakePipe[1] != -1)
+        close(wakePipe[1]);
+}
+
+void Reactor::open(int port, const std::string& backendName, bool reusePort) {
+    backend = EventBackend::create(backendName);
+    
+    // Self-pipe used by other threads (and the signal handler) to wake this loop
+    if (pipe(wakePipe) < 0 ||
+        fcntl(wakePipe[0], F_SETFL, O_NONBLOCK) < 0 ||
+        fcntl(wakePipe[1], F_SETFL, O_NONBLOCK) < 0) {
+        throw std::runtime_error("Failed to create wakeup pipe");
+    }
+    if (!backend->add(wakePipe[0], EventBackend::EVENT_READ)) {
+        throw std::runtime_error("Failed to register wakeup pipe");
+    }
+    
+    // Create the TCP listening socket
+    listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenSocket < 0) {
+        throw std::runtime_error("Failed to create socket");
+    }
+    // Enable address reuse so the socket can be re-bound quickly
+    int opt = 1;
+    if (setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
+        throw std::runtime_error("Failed to set socket options");
+    }
+    // Every reactor binds its own socket to the port, the kernel spreads new connections
+    if (reusePort && setsockopt(listenSocket, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        throw std::runtime_error("Failed to set SO_REUSEPORT");
+    }
+    // Put the server socket into non-blocking mode
+    if (fcntl(listenSocket, F_SETFL, O_NONBLOCK) < 0) {
+        throw std::runtime_error("Failed to set non-blocking mode");
+    }
+    // Configure the IPv4 bind address for this server instance
+    struct sockaddr_in serverAddr;
+    std::memset(&serverAddr, 0, sizeof(serverAddr));
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_addr.s_addr = INADDR_ANY;
+    serverAddr.sin_port = htons(port);
+    // Bind the listening socket to the configured address/port
+    if (bind(listenSocket, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) < 0) {
+        throw std::runtime_error("Failed to bind socket");
+    }
+    // Start listening for incoming connections on the bound socket
+    if (listen(listenSocket, 10) < 0) {
+        throw std::runtime_error("Failed to listen on socket");
+    }
+    // Register the listening socket with the event backend for incoming connections
+    if (!backend->addListener(listenSocket)) {
+        throw std::runtime_error("Failed to register listening socket");
+    }
+}
+
+Server* Reactor::getOwner() const {
+    return owner;
+}
+
+int Reactor::getId() const {
+    return id;
+}
+
+int Reactor::getListenSocket() const {
+    return listenSocket;
+}
+
+int Reactor::getWakeFd() const {
+    return wakePipe[0];
+}
+
+EventBackend* Reactor::getBackend() {
+    return backend;
+}
+
+ConnectionTable& Reactor::getConnections() {
+    return connections;
+}
+
+pthread_t& Reactor::getThread() {
+    return thread;
+}
+
+TimerWheel& Reactor::getTimers() {
+    return timers;
+}
+
+Timer& Reactor::getChannelSweep() {
+    return channelSweep;
+}
+
+Arena& Reactor::getArena() {
+    return arena;
+}
+
+bool Reactor::addClient(Client* client) {
+    if (!backend->addConnection(client->getFd())) {
+        return false;
+    }
+    connections.insert(client, EventBackend::EVENT_READ);
+    return true;
+}
+
+void Reactor::removeClient(int fd) {
+    backend->remove(fd);
+    Client* client = connections.erase(fd);
+    if (client) {
+        dirtyClients.remove(client);
+        removalClients.remove(client);
+        backlogClients.remove(client);
+        timers.cancel(&client->keepalive);
+    }
+}
+
+void Reactor::markDirty(Client* client) {
+    dirtyClients.pushBack(client);
+}
+
+Client* Reactor::takeDirty() {
+    return dirtyClients.popFront();
+}
+
+void Reactor::markForRemoval(Client* client) {
+    removalClients.pushBack(client);
+}
+
+Client* Reactor::takeRemoval() {
+    return removalClients.popFront();
+}
+
+void Reactor::deferInput(Client* client) {
+    backlogClients.pushBack(client);
+}
+
+Client* Reactor::takeBacklogged() {
+    return backlogClients.popFront();
+}
+
+Client* Reactor::lastBacklogged() const {
+    return backlogClients.back();
+}
+
+int Reactor::backlogTimeout(unsigned long now) const {
+    if (backlogClients.empty()) {
+        return -1;
+    }
+    unsigned long shortest = 0;
+    for (Client* client = backlogClients.front(); client != NULL; client = backlogClients.next(client)) {
+        unsigned long wait = client->floodBucket.delay(now);
+        if (wait == 0) {
+            return 0;
+        }
+        if (shortest == 0 || wait < shortest) {
+            shortest = wait;
+        }
+    }
+    return static_cast<int>(shortest);
+}
+
+// only talk to the backend when the registered interest actually changes.
+// completion backends have no write interest: asking for it starts a send
+void Reactor::updateEvents(int fd, unsigned int events) {
+    if (backend->completesIo()) {
+        Client* client = connections.find(fd);
+        if (client && (events & EventBackend::EVENT_WRITE)) {
+            submitSend(client);
+        }
+        return;
+    }
+    if (connections.getInterest(fd) == events) {
+        return;
+    }
+    if (backend->modify(fd, events)) {
+        connections.setInterest(fd, events);
+    }
+}
+
+// one send per client in flight, the next one starts from the EVENT_SENT handler
+void Reactor::submitSend(Client* client) {
+    if (client->isSendInFlight()) {
+        return;
+    }
+    struct iovec iov[Client::MAX_SEND_IOV];
+    SharedBuffer* buffers[Client::MAX_SEND_IOV];
+    int count = client->fillSendIov(iov, buffers, Client::MAX_SEND_IOV);
+    if (count == 0) {
+        return;
+    }
+    if (backend->submitSend(client->getFd(), iov, buffers, count)) {
+        client->setSendInFlight(true);
+    }
+}
+
+Reactor::Delivery::~Delivery() {
+    buffer->release();
+}
+
+void Reactor::post(Client* target, SharedBuffer* buffer, bool droppable) {
+    Delivery* delivery = new Delivery;
+    buffer->retain();
+    delivery->buffer = buffer;
+    delivery->droppable = droppable;
+    delivery->target.fd = target->getFd();
+    delivery->target.connectionId = target->getConnectionId();
+    inbox.push(delivery);
+    wakeup();
+}
+
+// a channel line for all our members in it costs one node and one wakeup
+void Reactor::post(SharedBuffer* buffer, std::vector<Target>& targets, bool droppable) {
+    Delivery* delivery = new Delivery;
+    buffer->retain();
+    delivery->buffer = buffer;
+    delivery->droppable = droppable;
+    delivery->target.fd = -1;
+    delivery->batch.swap(targets);
+    inbox.push(delivery);
+    wakeup();
+}
+
+// only the first poster after a drain pays for the write()
+void Reactor::wakeup() {
+    if (__atomic_exchange_n(&wakePending, 1, __ATOMIC_SEQ_CST) == 0) {
+        char byte = 1;
+        ssize_t written = write(wakePipe[1], &byte, 1);
+        (void)written;
+    }
+}
+
+void Reactor::drainInbox() {
+    char buffer[64];
+    while (read(wakePipe[0], buffer, sizeof(buffer)) > 0) {
+    }
+    // re-arm before draining so anything posted from now on wakes us again
+    __atomic_store_n(&wakePending, 0, __ATOMIC_SEQ_CST);
+    
+    MpscQueue::Node* node;
+    while ((node = inbox.pop()) != NULL) {
+        Delivery* delivery = static_cast<Delivery*>(node);
+        if (delivery->target.fd >= 0) {
+            deliver(delivery->target, delivery->buffer, delivery->droppable);
+        }
+        for (size_t i = 0; i < delivery->batch.size(); i++) {
+            deliver(delivery->batch[i], delivery->buffer, delivery->droppable);
+        }
+        delete delivery;
+    }
+}
+
+void Reactor::deliver(const Target& target, SharedBuffer* buffer, bool droppable) {
+    Client* client = connections.find(target.fd);
+    // the fd may have been closed and reused since the line was posted
+    if (client && client->getConnectionId() == target.connectionId) {
+        client->queueBuffer(buffer, droppable);
+    }
+}
+
+Reactor* Reactor::current() {
+    return currentReactor;
+}
+
+void Reactor::setCurrent(Reactor* reactor) {
+    currentReactor = reactor;
+}
@@ -0,0 +1,126 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Reactor.hpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:34:49 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 02:44:23 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef REACTOR_HPP
+#define REACTOR_HPP
+
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include "ConnectionTable.hpp"
+#include "EventBackend.hpp"
+#include "MpscQueue.hpp"
+#include "IntrusiveList.hpp"
+#include "TimerWheel.hpp"
+#include "Arena.hpp"
+#include "Client.hpp"
+
+class Server;
+class SharedBuffer;
+
+// one event loop thread: its own listening socket (SO_REUSEPORT when there
+// are several), event backend and clients. Other reactors never touch its
+// clients' buffers, they post to its inbox and wake it through a pipe.
+class Reactor {
+public:
+    // a client as seen from another thread: the fd may be reused by the
+    // time the line arrives, the connection id tells
+    struct Target {
+        int fd;
+        unsigned long connectionId;
+    };
+
+private:
+    // holds a reference to the line until the owner thread queues it
+    struct Delivery : public MpscQueue::Node {
+        SharedBuffer* buffer;
+        bool droppable;
+        Target target;                  // one client (fd -1 when unused)
+        std::vector<Target> batch;      // or all of these
+        ~Delivery();
+    };
+
+    Server* owner;
+    int id;
+    int listenSocket;
+    int wakePipe[2];
+    int wakePending;
+    EventBackend* backend;
+    ConnectionTable connections;
+    MpscQueue inbox;
+    pthread_t thread;
+    // clients that got output since the last flush, and clients to drop
+    IntrusiveList<Client, &Client::dirtyHook> dirtyClients;
+    IntrusiveList<Client, &Client::removalHook> removalClients;
+    // clients with buffered lines left over when their budget ran out, oldest first
+    IntrusiveList<Client, &Client::backlogHook> backlogClients;
+    // keepalives of our clients and deferred tasks, all run on this thread
+    TimerWheel timers;
+    Timer channelSweep;
+    // replies built while handling this iteration's events
+    Arena arena;
+
+    void deliver(const Target& target, SharedBuffer* buffer, bool droppable);
+
+    Reactor(const Reactor& other);
+    Reactor& operator=(const Reactor& other);
+
+public:
+    Reactor(Server* owner, int id);
+    ~Reactor();
+
+    void open(int port, const std::string& backendName, bool reusePort);
+
+    Server* getOwner() const;
+    int getId() const;
+    int getListenSocket() const;
+    int getWakeFd() const;
+    EventBackend* getBackend();
+    ConnectionTable& getConnections();
+    pthread_t& getThread();
+    TimerWheel& getTimers();
+    Timer& getChannelSweep();
+    Arena& getArena();
+
+    bool addClient(Client* client);
+    void removeClient(int fd);
+    void updateEvents(int fd, unsigned int events);
+    // completion backends: hand the client's pending output to the kernel
+    void submitSend(Client* client);
+
+    // owner thread: collected during the iteration, handled once at its end
+    void markDirty(Client* client);
+    Client* takeDirty();
+    void markForRemoval(Client* client);
+    Client* takeRemoval();
+    void deferInput(Client* client);
+    Client* takeBacklogged();
+    Client* lastBacklogged() const;
+    // how long the loop may block: -1 without a backlog, 0 when some client
+    // can go on right away, else until the first throttled client gets a token
+    int backlogTimeout(unsigned long now) const;
+
+    // any thread: queue a line for one of our clients and wake the loop
+    void post(Client* target, SharedBuffer* buffer, bool droppable);
+    // the same for several clients in one delivery; targets is left empty
+    void post(SharedBuffer* buffer, std::vector<Target>& targets, bool droppable);
+    // any thread, also safe from a signal handler
+    void wakeup();
+    // owner thread: hand posted lines to their clients
+    void drainInbox();
+
+    // reactor running on the calling thread (NULL outside reactor threads)
+    static Reactor* current();
+    static void setCurrent(Reactor* reactor);
+};
+
+#endif
@@ -0,0 +1,98 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ReplyBuilder.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 00:40:24 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 00:40:24 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "ReplyBuilder.hpp"
+#include "Arena.hpp"
+#include "Reactor.hpp"
+#include <cstring>
+
+// room for a typical reply, most lines never grow past it
+static const size_t INITIAL_CAPACITY = 128;
+
+ReplyBuilder::ReplyBuilder()
+    : arena(Reactor::current()->getArena()), buffer(NULL), length(0), capacity(0) {
+}
+
+ReplyBuilder::ReplyBuilder(Arena& arena)
+    : arena(arena), buffer(NULL), length(0), capacity(0) {
+}
+
+// growing usually happens in place, the line is the newest thing in the arena
+char* ReplyBuilder::reserve(size_t extra) {
+    if (length + extra > capacity) {
+        size_t grown = capacity ? capacity * 2 : INITIAL_CAPACITY;
+        if (grown < length + extra)
+            grown = length + extra;
+        buffer = static_cast<char*>(arena.extend(buffer, capacity, grown));
+        capacity = grown;
+    }
+    return buffer + length;
+}
+
+ReplyBuilder& ReplyBuilder::operator<<(const StringRef& text) {
+    if (text.length) {
+        std::memcpy(reserve(text.length), text.data, text.length);
+        length += text.length;
+    }
+    return *this;
+}
+
+ReplyBuilder& ReplyBuilder::operator<<(const char* text) {
+    return *this << StringRef(text);
+}
+
+ReplyBuilder& ReplyBuilder::operator<<(char c) {
+    *reserve(1) = c;
+    length++;
+    return *this;
+}
+
+ReplyBuilder& ReplyBuilder::operator<<(int value) {
+    return *this << static_cast<long>(value);
+}
+
+ReplyBuilder& ReplyBuilder::operator<<(unsigned int value) {
+    return *this << static_cast<unsigned long>(value);
+}
+
+ReplyBuilder& ReplyBuilder::operator<<(long value) {
+    if (value < 0) {
+        *this << '-';
+        // negate in unsigned arithmetic, LONG_MIN has no positive counterpart
+        return *this << (0UL - static_cast<unsigned long>(value));
+    }
+    return *this << static_cast<unsigned long>(value);
+}
+
+ReplyBuilder& ReplyBuilder::operator<<(unsigned long value) {
+    char digits[24];
+    size_t count = 0;
+    do {
+        digits[sizeof(digits) - 1 - count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value);
+    std::memcpy(reserve(count), digits + sizeof(digits) - count, count);
+    length += count;
+    return *this;
+}
+
+const char* ReplyBuilder::data() const {
+    return buffer ? buffer : "";
+}
+
+size_t ReplyBuilder::size() const {
+    return length;
+}
+
+ReplyBuilder::operator StringRef() const {
+    return StringRef(data(), length);
+}
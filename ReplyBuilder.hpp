@@ -0,0 +1,55 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ReplyBuilder.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 00:40:23 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 00:40:23 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef REPLYBUILDER_HPP
+#define REPLYBUILDER_HPP
+
+#include <cstddef>
+#include "StringRef.hpp"
+
+class Arena;
+
+// one outgoing line put together in the reactor's arena, e.g.
+//   client->queueMessage(ReplyBuilder() << "403 " << name << " :No such channel");
+// the bytes stay valid until the end of the loop iteration, long enough
+// to be copied into an output queue or a shared buffer
+class ReplyBuilder {
+private:
+    Arena& arena;
+    char* buffer;
+    size_t length;
+    size_t capacity;
+
+    char* reserve(size_t extra);
+
+    ReplyBuilder(const ReplyBuilder& other);
+    ReplyBuilder& operator=(const ReplyBuilder& other);
+
+public:
+    // the calling reactor's arena
+    ReplyBuilder();
+    explicit ReplyBuilder(Arena& arena);
+
+    ReplyBuilder& operator<<(const StringRef& text);
+    ReplyBuilder& operator<<(const char* text);
+    ReplyBuilder& operator<<(char c);
+    ReplyBuilder& operator<<(int value);
+    ReplyBuilder& operator<<(unsigned int value);
+    ReplyBuilder& operator<<(long value);
+    ReplyBuilder& operator<<(unsigned long value);
+
+    const char* data() const;
+    size_t size() const;
+    operator StringRef() const;
+};
+
+#endif
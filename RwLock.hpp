@@ -0,0 +1,70 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RwLock.hpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 01:51:56 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 01:51:56 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef RWLOCK_HPP
+#define RWLOCK_HPP
+
+#include <pthread.h>
+
+// many readers or one writer. writers go first once they wait, so a steady
+// stream of readers cannot hold off a NICK or JOIN forever
+class RwLock {
+private:
+    pthread_rwlock_t handle;
+
+    RwLock(const RwLock& other);
+    RwLock& operator=(const RwLock& other);
+
+public:
+    RwLock() {
+        pthread_rwlockattr_t attributes;
+        pthread_rwlockattr_init(&attributes);
+#ifdef __GLIBC__
+        pthread_rwlockattr_setkind_np(&attributes, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+        pthread_rwlock_init(&handle, &attributes);
+        pthread_rwlockattr_destroy(&attributes);
+    }
+    ~RwLock() { pthread_rwlock_destroy(&handle); }
+
+    void lockShared() { pthread_rwlock_rdlock(&handle); }
+    void lockExclusive() { pthread_rwlock_wrlock(&handle); }
+    void unlock() { pthread_rwlock_unlock(&handle); }
+};
+
+// holds the lock shared for the lifetime of the guard
+class ReadLock {
+private:
+    RwLock& rwlock;
+
+    ReadLock(const ReadLock& other);
+    ReadLock& operator=(const ReadLock& other);
+
+public:
+    explicit ReadLock(RwLock& l) : rwlock(l) { rwlock.lockShared(); }
+    ~ReadLock() { rwlock.unlock(); }
+};
+
+// holds the lock exclusively for the lifetime of the guard
+class WriteLock {
+private:
+    RwLock& rwlock;
+
+    WriteLock(const WriteLock& other);
+    WriteLock& operator=(const WriteLock& other);
+
+public:
+    explicit WriteLock(RwLock& l) : rwlock(l) { rwlock.lockExclusive(); }
+    ~WriteLock() { rwlock.unlock(); }
+};
+
+#endif
@@ -6,7 +6,7 @@
 /*   By: msimic <msimic@student.42.fr>              +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/19 18:03:52 by mvolgger          #+#    #+#             */
-/*   Updated: 2025/12/20 15:15:03 by msimic           ###   ########.fr       */
+/*   Updated: 2026/10/17 02:44:23 by kbrauer          ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -15,6 +15,16 @@
 #include "Server.hpp"
 #include "Client.hpp"
 #include "Channel.hpp"
+#include "EventBackend.hpp"
+#include "Reactor.hpp"
+#include "IrcMessage.hpp"
+#include "BufferPool.hpp"
+#include "SharedBuffer.hpp"
+#include "Fanout.hpp"
+#include "Clock.hpp"
+#include "SlabAllocator.hpp"
+#include "ReplyBuilder.hpp"
+#include "Logger.hpp"
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -22,169 +32,301 @@
 #include <unistd.h>
 #include <cstring>
 #include <cstdlib>
-#include <iostream>
-#include <sstream>
 #include <cerrno>
 #include <algorithm>
+#include <csignal>
+#include <stdexcept>
+#include <ctime>
 
 
-Server::Server(int port, const std::string& password) 
-    : serverSocket(-1), 
-      port(port), 
+// command name and the checks done before its handler runs
+const Server::CommandSpec Server::commandTable[] = {
+    { "PASS",    &Server::cmdPass,    1, false, true,  true  },
+    { "NICK",    &Server::cmdNick,    0, false, false, false },
+    { "USER",    &Server::cmdUser,    4, false, true,  false },
+    { "JOIN",    &Server::cmdJoin,    1, true,  false, false },
+    { "PART",    &Server::cmdPart,    1, true,  false, false },
+    { "PRIVMSG", &Server::cmdPrivmsg, 0, true,  false, true  },
+    { "KICK",    &Server::cmdKick,    2, true,  false, false },
+    { "INVITE",  &Server::cmdInvite,  2, true,  false, false },
+    { "TOPIC",   &Server::cmdTopic,   1, true,  false, false },
+    { "MODE",    &Server::cmdMode,    1, true,  false, false },
+    { "QUIT",    &Server::cmdQuit,    0, false, false, false },
+    { "PING",    &Server::cmdPing,    0, false, false, true  },
+    { "PONG",    &Server::cmdPong,    0, false, false, true  },
+    { "STATS",   &Server::cmdStats,   0, true,  false, true  }
+};
+
+enum {
+    CMD_PASS, CMD_NICK, CMD_USER, CMD_JOIN, CMD_PART, CMD_PRIVMSG, CMD_KICK,
+    CMD_INVITE, CMD_TOPIC, CMD_MODE, CMD_QUIT, CMD_PING, CMD_PONG, CMD_STATS,
+    COMMAND_COUNT
+};
+
+// first four bytes of a command name as one switch key
+#define COMMAND_KEY(a, b, c, d) \
+    (((unsigned int)(a) << 24) | ((unsigned int)(b) << 16) | ((unsigned int)(c) << 8) | (unsigned int)(d))
+
+Server::Server(int port, const std::string& password, const ServerConfig& config) 
+    : port(port), 
       password(password), 
       serverName("ircserv"),
+      serverVersion("ircserv-1.0"),
+      config(config),
+      nextConnectionId(1),
+      fanoutEpoch(0),
+      commandStats(COMMAND_COUNT),
       isRunning(false) {
+    char stamp[64];
+    time_t now = time(NULL);
+    strftime(stamp, sizeof(stamp), "%a %b %d %Y at %H:%M:%S UTC", gmtime(&now));
+    createdAt = stamp;
 }
 
 Server::~Server() {
-    for (std::map<int, Client*>::iterator it = clients.begin(); it != clients.end(); ++it) {
-        delete it->second;
+    for (size_t r = 0; r < reactors.size(); r++) {
+        ConnectionTable& clients = reactors[r]->getConnections();
+        for (size_t i = 0; i < clients.size(); i++) {
+            delete clients.at(i);
+        }
     }
     
-    for (std::map<std::string, Channel*>::iterator it = channels.begin(); it != channels.end(); ++it) {
-        delete it->second;
+    std::vector<Channel*> allChannels;
+    channels.collect(allChannels);
+    channels.clear();
+    for (size_t i = 0; i < allChannels.size(); i++) {
+        delete allChannels[i];
     }
     
-    if (serverSocket != -1) {
-        close(serverSocket);
+    for (size_t r = 0; r < reactors.size(); r++) {
+        delete reactors[r];
     }
+    BufferPool::trim();
 }
 
-void Server::setupServerSocket() {
-    // Create the TCP listening socket
-    serverSocket = socket(AF_INET, SOCK_STREAM, 0);
-    if (serverSocket < 0) {
-        throw std::runtime_error("Failed to create socket");
-    }
-    // Enable address reuse so the socket can be re-bound quickly
-    int opt = 1;
-    if (setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
-        close(serverSocket);
-        throw std::runtime_error("Failed to set socket options");
-    }
-    // Put the server socket into non-blocking mode
-    if (fcntl(serverSocket, F_SETFL, O_NONBLOCK) < 0) {
-        close(serverSocket);
-        throw std::runtime_error("Failed to set non-blocking mode");
-    }
-    // Configure the IPv4 bind address for this server instance
-    struct sockaddr_in serverAddr;
-    std::memset(&serverAddr, 0, sizeof(serverAddr));
-    serverAddr.sin_family = AF_INET;
-    serverAddr.sin_addr.s_addr = INADDR_ANY;
-    serverAddr.sin_port = htons(port);
-    // Bind the listening socket to the configured address/port
-    if (bind(serverSocket, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) < 0) {
-        close(serverSocket);
-        throw std::runtime_error("Failed to bind socket");
-    }
-    // Start listening for incoming connections on the bound socket
-    if (listen(serverSocket, 10) < 0) {
-        close(serverSocket);
-        throw std::runtime_error("Failed to listen on socket");
-    }
-    // Register the listening socket with poll for incoming data events
-    struct pollfd serverPollFd;
-    serverPollFd.fd = serverSocket;
-    serverPollFd.events = POLLIN;
-    serverPollFd.revents = 0;
-    pollFds.push_back(serverPollFd);
-    
-    std::cout << "Server listening on port " << port << std::endl;
+void Server::acceptNewClient(Reactor* reactor) {
+    // Accept every pending connection: an edge-triggered backend
+    // will not report the listening socket again until a new one arrives
+    while (true) {
+        // Accept a new client connection, capturing its address
+        // and tolerating non-blocking retry cases
+        struct sockaddr_in clientAddr;
+        socklen_t clientLen = sizeof(clientAddr);
+        int clientSocket = accept(reactor->getListenSocket(), (struct sockaddr*)&clientAddr, &clientLen);
+        if (clientSocket < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EWOULDBLOCK && errno != EAGAIN) {
+                LOG(ERROR) << "Error accepting client";
+            }
+            return;
+        }
+        if (fcntl(clientSocket, F_SETFL, O_NONBLOCK) < 0) {
+            LOG(ERROR) << "Failed to set client socket to non-blocking";
+            close(clientSocket);
+            continue;
+        }
+        registerClient(reactor, clientSocket, clientAddr);
+    }
 }
 
-void Server::acceptNewClient() {
-    // Accept a new client connection, capturing its address
-    // and tolerating non-blocking retry cases
+// completion backends accept on their own and only report the new socket
+void Server::handleAcceptedClient(Reactor* reactor, int clientSocket) {
     struct sockaddr_in clientAddr;
     socklen_t clientLen = sizeof(clientAddr);
-    int clientSocket = accept(serverSocket, (struct sockaddr*)&clientAddr, &clientLen);
-    if (clientSocket < 0) {
-        if (errno != EWOULDBLOCK && errno != EAGAIN) {
-            std::cerr << "Error accepting client" << std::endl;
-        }
-        return;
-    }
-    if (fcntl(clientSocket, F_SETFL, O_NONBLOCK) < 0) {
-        std::cerr << "Failed to set client socket to non-blocking" << std::endl;
-        close(clientSocket);
-        return;
-    }
-    
-    // Create the client object, resolve its hostname,
-    // and register it by socket id
-    Client* newClient = new Client(clientSocket);
+    std::memset(&clientAddr, 0, sizeof(clientAddr));
+    getpeername(clientSocket, (struct sockaddr*)&clientAddr, &clientLen);
+    registerClient(reactor, clientSocket, clientAddr);
+}
+
+void Server::registerClient(Reactor* reactor, int clientSocket, const struct sockaddr_in& clientAddr) {
     // Set client hostname from connection address
     char hostStr[INET_ADDRSTRLEN];
     inet_ntop(AF_INET, &(clientAddr.sin_addr), hostStr, INET_ADDRSTRLEN);
-    newClient->setHostname(hostStr);
     
-    clients[clientSocket] = newClient;
+    // Create the client object and register it with this reactor.
+    // Other reactors walk the connection tables during nick lookups,
+    // so the table only changes under the state lock
+    WriteLock guard(stateLock);
+    Client* newClient = new Client(clientSocket, reactor, nextConnectionId++);
+    newClient->setHostname(hostStr);
+    applySendQClass(newClient);
+    newClient->getFloodBucket().configure(config.floodRate, config.floodBurst);
+    
+    // the keepalive timer starts out as the registration deadline
+    unsigned long now = monotonicMs();
+    Timer& keepalive = newClient->getKeepalive();
+    keepalive.callback = &Server::keepaliveExpired;
+    keepalive.context = newClient;
+    newClient->noteActivity(now);
+    if (!reactor->addClient(newClient)) {
+        LOG(ERROR) << "Failed to register client socket";
+        delete newClient;
+        return;
+    }
     
-    // Register the new client socket with poll to watch for incoming data
-    struct pollfd clientPollFd;
-    clientPollFd.fd = clientSocket;
-    clientPollFd.events = POLLIN;
-    clientPollFd.revents = 0;
-    pollFds.push_back(clientPollFd);
+    reactor->getTimers().schedule(&keepalive, config.registerTimeout * 1000, now);
     
-    std::cout << "New client connected: fd " << clientSocket 
-              << " from " << hostStr << std::endl;
+    LOG(INFO) << "New client connected: fd " << clientSocket << " from " << hostStr;
 }
 
 void Server::start() {
-    setupServerSocket();
+    size_t count = config.threads;
+    for (size_t i = 0; i < count; i++) {
+        reactors.push_back(new Reactor(this, i));
+        reactors[i]->open(port, config.backend, count > 1);
+        reactors[i]->getChannelSweep().callback = &Server::channelSweepExpired;
+        reactors[i]->getChannelSweep().context = reactors[i];
+    }
+    LOG(INFO) << "Server listening on port " << port;
     isRunning = true;
     
-    std::cout << "Server started. Waiting for connections..." << std::endl;
+    LOG(INFO) << "Server started (" << reactors[0]->getBackend()->getName() 
+              << " backend, " << count << " reactor thread" << (count > 1 ? "s" : "")
+              << "). Waiting for connections...";
+    
+    // SIGINT/SIGTERM must land on the main thread, so the workers start with them blocked
+    sigset_t blocked;
+    sigset_t previous;
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGINT);
+    sigaddset(&blocked, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+    size_t started = 1;
+    for (; started < count; started++) {
+        if (pthread_create(&reactors[started]->getThread(), NULL,
+                           &Server::reactorThread, reactors[started]) != 0) {
+            break;
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
     
+    if (started == count) {
+        runReactor(reactors[0]);
+    } else {
+        LOG(ERROR) << "Failed to start reactor thread";
+    }
+    
+    // the main loop may also end on an error, make sure the workers follow
+    stop();
+    for (size_t i = 1; i < started; i++) {
+        pthread_join(reactors[i]->getThread(), NULL);
+    }
+    if (started != count) {
+        throw std::runtime_error("Failed to start reactor threads");
+    }
+}
+
+void* Server::reactorThread(void* arg) {
+    Reactor* reactor = static_cast<Reactor*>(arg);
+    reactor->getOwner()->runReactor(reactor);
+    return NULL;
+}
+
+// -1 waits forever, so it loses against any real timeout
+static int earliestTimeout(int first, int second) {
+    if (first < 0)
+        return second;
+    if (second < 0)
+        return first;
+    return first < second ? first : second;
+}
+
+void Server::runReactor(Reactor* reactor) {
+    Reactor::setCurrent(reactor);
+    EventBackend* backend = reactor->getBackend();
+    TimerWheel& timers = reactor->getTimers();
+    
+    std::vector<EventBackend::Event> ready;
     while (isRunning) {
-        // Poll all tracked sockets for readiness
-        int pollCount = poll(&pollFds[0], pollFds.size(), -1);
-        if (pollCount < 0) {
+        // Wait until at least one tracked socket is ready, the next timer
+        // bucket comes up, or deferred input can go on
+        unsigned long now = monotonicMs();
+        int timeout = earliestTimeout(timers.timeout(now), reactor->backlogTimeout(now));
+        int readyCount = backend->wait(ready, timeout);
+        if (readyCount < 0) {
             if (errno == EINTR) {
                 continue;  // interrupted by signal, just retry
             }
-            std::cerr << "Poll error" << std::endl;
+            LOG(ERROR) << "Event wait error";
             break;
         }
         
-        // handle events
-        for (size_t i = pollFds.size(); i > 0; i--) {
-            size_t idx = i - 1;
+        // keepalives and deferred tasks that came due while waiting
+        timers.advance(monotonicMs());
+        
+        // lines left over from earlier turns go first, before new input
+        serviceBacklog(reactor);
+        
+        // handle events, only the ready sockets are visited
+        for (size_t i = 0; i < ready.size(); i++) {
+            int fd = ready[i].fd;
+            unsigned int events = ready[i].events;
             
-            // Skip sockets with no reported events this cycle
-            if (pollFds[idx].revents == 0) {
-                continue;
-            }
             // If the listening socket is readable, accept incoming client connections
-            if (pollFds[idx].fd == serverSocket) {
-                if (pollFds[idx].revents & POLLIN) {
-                    acceptNewClient();
-                }
-            } else { // Handle activity on an existing client socket
-                // Drop the client if the socket reports an error, hangup, or invalid state
-                if (pollFds[idx].revents & (POLLERR | POLLHUP | POLLNVAL)) {
-                    removeClient(pollFds[idx].fd);
-                    continue;
-                }
-                // Process readable client data
-                if (pollFds[idx].revents & POLLIN) {
-                    handleClientData(pollFds[idx].fd);
+            if (fd == reactor->getListenSocket()) {
+                if (events & EventBackend::EVENT_ACCEPT) {
+                    handleAcceptedClient(reactor, ready[i].result);
+                } else if (events & EventBackend::EVENT_READ) {
+                    acceptNewClient(reactor);
                 }
-                // Flush queued data to the client when the socket is writable
-                if (pollFds[idx].revents & POLLOUT) {
-                    handleClientWrite(pollFds[idx].fd);
+                continue;
+            }
+            // Lines posted by other reactors for our clients
+            if (fd == reactor->getWakeFd()) {
+                reactor->drainInbox();
+                continue;
+            }
+            // Handle activity on an existing client socket
+            // Drop the client if the socket reports an error or hangup
+            if (events & (EventBackend::EVENT_HANGUP | EventBackend::EVENT_ERROR)) {
+                removeClient(reactor, fd);
+                continue;
+            }
+            // Process readable client data
+            if (events & EventBackend::EVENT_READ) {
+                handleClientData(reactor, fd);
+            }
+            // Data already received by a completion backend
+            if (events & EventBackend::EVENT_DATA) {
+                handleReceivedData(reactor, fd, ready[i].data, ready[i].length);
+            }
+            if (events & EventBackend::EVENT_EOF) {
+                Client* client = reactor->getConnections().find(fd);
+                if (client && !client->isMarkedForRemoval()) {
+                    LOG(INFO) << "Client " << fd << " disconnected";
+                    size_t budget = COMMAND_BUDGET;
+                    closeInput(reactor, client, budget);
                 }
             }
+            // Flush queued data to the client when the socket is writable
+            if (events & EventBackend::EVENT_WRITE) {
+                handleClientWrite(reactor, fd);
+            }
+            // A send submitted to a completion backend has finished
+            if (events & EventBackend::EVENT_SENT) {
+                handleSendCompleted(reactor, fd, ready[i].result);
+            }
         }
         
-        removeMarkedClients();
+        // removals announce QUITs, so they go before the flush
+        removeMarkedClients(reactor);
+        sendAllData(reactor);
+        
+        // every reply of this iteration has been copied into a queue by now
+        reactor->getArena().reset();
     }
+    BufferPool::trim();
+    SlabAllocator::releaseThreadCache();
 }
 
+// may run inside the signal handler: only flips the flag and pokes the wakeup pipes
 void Server::stop() {
     isRunning = false;
+    for (size_t i = 0; i < reactors.size(); i++) {
+        reactors[i]->wakeup();
+    }
 }
 
 const std::string& Server::getPassword() const {
@@ -196,155 +338,350 @@ const std::string& Server::getServerName() const {
 }
 
 // client data handling
-void Server::handleClientData(int clientFd) {
-    Client* client = clients[clientFd];
-    if (!client || client->isMarkedForRemoval()) 
+void Server::handleClientData(Reactor* reactor, int clientFd) {
+    Client* client = reactor->getConnections().find(clientFd);
+    if (!client || client->isMarkedForRemoval() || client->isInputClosed()) 
         return;
     
-    char buffer[512];
-    std::memset(buffer, 0, sizeof(buffer));
+    // drain the socket: with an edge-triggered backend we are not told
+    // again about bytes that are left unread
+    InputBuffer& input = client->getInputBuffer();
+    size_t budget = COMMAND_BUDGET;
+    bool received = false;
+    bool disconnected = false;
+    while (!client->isMarkedForRemoval()) {
+        // a full buffer holds complete lines, handle them to make room
+        if (input.space() == 0) {
+            processInput(client, budget);
+            if (input.space() == 0) {
+                // out of budget or tokens: the rest stays in the socket, TCP
+                // pushes back, and reading resumes once the backlog drains
+                pauseInput(reactor, client);
+                break;
+            }
+            continue;
+        }
+        
+        ssize_t bytesRead = recv(clientFd, input.writePtr(), input.space(), 0);
+        
+        if (bytesRead <= 0) {
+            if (bytesRead == 0) {
+                LOG(INFO) << "Client " << clientFd << " disconnected";
+            } else if (errno == EINTR) {
+                continue;
+            } else if (errno != EWOULDBLOCK && errno != EAGAIN) {
+                LOG(ERROR) << "Error reading from client " << clientFd;
+            } else {
+                break;
+            }
+            disconnected = true;
+            break;
+        }
+        
+        input.commit(bytesRead);
+        received = true;
+    }
+    if (received) {
+        client->noteActivity(monotonicMs());
+    }
     
-    ssize_t bytesRead = recv(clientFd, buffer, sizeof(buffer) - 1, 0);
+    if (disconnected) {
+        closeInput(reactor, client, budget);
+        return;
+    }
+    processInput(client, budget);
+    if (input.hasLine()) {
+        reactor->deferInput(client);
+    }
+}
+
+void Server::handleReceivedData(Reactor* reactor, int clientFd, const char* data, size_t length) {
+    Client* client = reactor->getConnections().find(clientFd);
+    if (!client || client->isMarkedForRemoval()) 
+        return;
     
-    if (bytesRead <= 0) {
-        if (bytesRead == 0) {
-            std::cout << "Client " << clientFd << " disconnected" << std::endl;
-        } else if (errno != EWOULDBLOCK && errno != EAGAIN) {
-            std::cerr << "Error reading from client" << clientFd << std::endl;
-        } else {
+    // the kernel's buffer is recycled after this event, copy it in block-sized pieces.
+    // it cannot be left in the socket, so when the lines in the way are over
+    // budget only the flood tokens hold them back, and a client that fills its
+    // whole buffer without tokens left is cut off like an ircd RecvQ overflow
+    InputBuffer& input = client->getInputBuffer();
+    size_t budget = COMMAND_BUDGET;
+    client->noteActivity(monotonicMs());
+    while (length > 0 && !client->isMarkedForRemoval()) {
+        size_t taken = input.append(data, length);
+        data += taken;
+        length -= taken;
+        if (length == 0) {
+            break;
+        }
+        processInput(client, budget);
+        if (input.space() == 0) {
+            size_t unlimited = static_cast<size_t>(-1);
+            processInput(client, unlimited);
+        }
+        if (input.space() == 0) {
+            closeLink(client, "Excess Flood");
             return;
         }
-        removeClient(clientFd);
-        return;
     }
-    
-    client->getInputBuffer() += std::string(buffer, bytesRead);
-    
-    std::string& inputBuffer = client->getInputBuffer();
-    size_t pos;
-    
-    while ((pos = inputBuffer.find('\n')) != std::string::npos) {
-        std::string line = inputBuffer.substr(0, pos);
-        inputBuffer.erase(0, pos + 1);
-        
-        //REMOVE \n, only needed to find the end of cmd
-        if (!line.empty() && line[line.size() - 1] == '\r') {
-            line.erase(line.size() - 1);
+    processInput(client, budget);
+    if (input.hasLine()) {
+        reactor->deferInput(client);
+    }
+}
+
+// lines are handed out as pointers into the input buffer and parsed in place.
+// parses at most budget lines, each paid for with a flood token; the rest
+// stays buffered for a later turn
+void Server::processInput(Client* client, size_t& budget) {
+    int clientFd = client->getFd();
+    InputBuffer& input = client->getInputBuffer();
+    TokenBucket& tokens = client->getFloodBucket();
+    const char* data;
+    size_t length;
+    
+    tokens.refill(monotonicMs());
+    
+    while (budget > 0 && !client->isMarkedForRemoval() && input.hasLine() && tokens.take()) {
+        budget--;
+        InputBuffer::LineStatus status = input.nextLine(data, length);
+        if (status == InputBuffer::LINE_NONE) {
+            break;
+        }
+        if (status == InputBuffer::LINE_TOO_LONG) {
+            sendNumeric(client, ERR_INPUTTOOLONG);
+            continue;
         }
         
-        if (line.empty()) continue;
+        if (length == 0) continue;
         
-        std::cout << "Received from " << clientFd << ": " << line << std::endl;
-        parseCommand(client, line);
+        LOG(DEBUG) << "Received from " << clientFd << ": " << StringRef(data, length);
+        parseCommand(client, data, length);
     }
-    
-    // check if client has data to send after processing
-    if (client->hasDataToSend()) {
-        updatePollEvents(clientFd, POLLIN | POLLOUT);
+    input.compact();
+}
+
+// the peer will send nothing more, but the lines it sent before its EOF still
+// count. they run at the flood rate like any others, from the backlog, and
+// the client is dropped once they are used up
+void Server::closeInput(Reactor* reactor, Client* client, size_t& budget) {
+    client->setInputClosed(true);
+    processInput(client, budget);
+    if (client->isMarkedForRemoval()) {
+        return;
+    }
+    if (client->getInputBuffer().hasLine()) {
+        // a readiness backend would keep reporting the EOF
+        pauseInput(reactor, client);
+        reactor->deferInput(client);
+        return;
     }
+    client->setMarkedForRemoval(true);
+}
+
+// readiness backends: stop asking for input while the buffer is full of deferred lines
+void Server::pauseInput(Reactor* reactor, Client* client) {
+    int fd = client->getFd();
+    unsigned int interest = reactor->getConnections().getInterest(fd);
+    reactor->updateEvents(fd, interest & ~EventBackend::EVENT_READ);
+}
+
+// re-arming the read interest reports whatever waited in the socket meanwhile,
+// edge-triggered epoll included
+void Server::resumeInput(Reactor* reactor, Client* client) {
+    if (client->isInputClosed()) {
+        return;
+    }
+    int fd = client->getFd();
+    unsigned int interest = reactor->getConnections().getInterest(fd);
+    if (!(interest & EventBackend::EVENT_READ) && client->getInputBuffer().space() > 0) {
+        reactor->updateEvents(fd, interest | EventBackend::EVENT_READ);
+    }
+}
+
+// round robin: every client that had lines left at the start of the iteration
+// gets one more budget, in arrival order. whoever still has lines goes to the
+// back, behind clients deferred later, so one heavy sender cannot starve the rest
+void Server::serviceBacklog(Reactor* reactor) {
+    Client* last = reactor->lastBacklogged();
+    if (!last) {
+        return;
+    }
+    Client* client;
+    do {
+        client = reactor->takeBacklogged();
+        if (!client->isMarkedForRemoval()) {
+            size_t budget = COMMAND_BUDGET;
+            processInput(client, budget);
+            if (client->getInputBuffer().hasLine()) {
+                reactor->deferInput(client);
+            } else if (client->isInputClosed()) {
+                client->setMarkedForRemoval(true);
+            }
+            resumeInput(reactor, client);
+        }
+    } while (client != last);
 }
 
-void Server::handleClientWrite(int clientFd) {
-    Client* client = clients[clientFd];
+void Server::handleClientWrite(Reactor* reactor, int clientFd) {
+    Client* client = reactor->getConnections().find(clientFd);
     if (!client || client->isMarkedForRemoval()) 
         return;
     
     if (client->sendOutputBuffer()) {
-        // after sending data remove POLLOUT
-        updatePollEvents(clientFd, POLLIN);
+        // after sending data stop waiting for writability
+        unsigned int interest = reactor->getConnections().getInterest(clientFd);
+        reactor->updateEvents(clientFd, interest & ~EventBackend::EVENT_WRITE);
     }
 }
 
-void Server::updatePollEvents(int fd, short events) {
-    for (size_t i = 0; i < pollFds.size(); i++) {
-        if (pollFds[i].fd == fd) {
-            pollFds[i].events = events;
-            return;
-        }
+void Server::handleSendCompleted(Reactor* reactor, int clientFd, int result) {
+    Client* client = reactor->getConnections().find(clientFd);
+    if (!client) 
+        return;
+    
+    client->setSendInFlight(false);
+    if (result < 0) {
+        LOG(ERROR) << "Error sending to client " << clientFd << ": " << -result;
+        removeClient(reactor, clientFd);
+        return;
+    }
+    client->completeSend(result);
+    // whatever was queued meanwhile goes out with the next submission
+    if (client->hasDataToSend()) {
+        reactor->markDirty(client);
+    } else if (client->isMarkedForRemoval()) {
+        // a lingering client has said its last words
+        client->setMarkedForRemoval(true);
     }
 }
 
-// update poll events for all clients that have data waiting to be sent
-void Server::sendAllData() {
-    for (std::map<int, Client*>::iterator it = clients.begin(); 
-         it != clients.end(); ++it) {
-        if (it->second->hasDataToSend()) {
-            updatePollEvents(it->first, POLLIN | POLLOUT);
+// once per loop iteration, only for the clients that got output since the last
+// flush (clients of other reactors are marked when their inbox is drained).
+// write-through: most replies fit into the socket buffer, so they are sent
+// right away and write interest is only armed when the kernel pushes back.
+// a client already waiting for writability is known to be congested and is
+// left to the backend until the socket drains
+void Server::sendAllData(Reactor* reactor) {
+    bool completesIo = reactor->getBackend()->completesIo();
+    Client* client;
+    while ((client = reactor->takeDirty()) != NULL) {
+        if (!client->hasDataToSend()) {
+            continue;
+        }
+        int fd = client->getFd();
+        unsigned int interest = reactor->getConnections().getInterest(fd);
+        if (completesIo || (interest & EventBackend::EVENT_WRITE)) {
+            reactor->updateEvents(fd, interest | EventBackend::EVENT_WRITE);
+            continue;
+        }
+        if (!client->sendOutputBuffer()) {
+            reactor->updateEvents(fd, interest | EventBackend::EVENT_WRITE);
         }
     }
 }
 
-void Server::parseCommand(Client* client, const std::string& message) {
-    std::vector<std::string> tokens;
-    std::istringstream iss(message);
-    std::string token;
-    
-    while (iss >> token) {
-        if (token[0] == ':' && tokens.size() > 0) {
-            std::string rest = token.substr(1);
-            std::string remainder;
-            if (std::getline(iss, remainder)) {
-                rest += remainder;
-            }
-            tokens.push_back(rest);
-            break;
-        }
-        tokens.push_back(token);
-    }
-    
-    if (tokens.empty()) return;
-    
-    std::string command = tokens[0];
-    for (size_t i = 0; i < command.length(); i++) {
-        command[i] = std::toupper(command[i]);
-    }
-    
-    if (command == "PASS") {
-        cmdPass(client, tokens);
-    } else if (command == "NICK") {
-        cmdNick(client, tokens);
-    } else if (command == "USER") {
-        cmdUser(client, tokens);
-    } else if (command == "JOIN") {
-        cmdJoin(client, tokens);
-    } else if (command == "PART") {
-        cmdPart(client, tokens);
-    } else if (command == "PRIVMSG") {
-        cmdPrivmsg(client, tokens);
-    } else if (command == "KICK") {
-        cmdKick(client, tokens);
-    } else if (command == "INVITE") {
-        cmdInvite(client, tokens);
-    } else if (command == "TOPIC") {
-        cmdTopic(client, tokens);
-    } else if (command == "MODE") {
-        cmdMode(client, tokens);
-    } else if (command == "QUIT") {
-        cmdQuit(client, tokens);
-    } else if (command == "PING") {
-        cmdPing(client, tokens);
-    } else {
+// one switch on the packed, upper-cased prefix picks the only candidate,
+// which is then compared in full
+int Server::findCommand(const StringRef& command) {
+    unsigned int key = 0;
+    for (size_t i = 0; i < 4; i++) {
+        char c = (i < command.length) ? command.data[i] : '\0';
+        if (c >= 'a' && c <= 'z')
+            c -= 'a' - 'A';
+        key = (key << 8) | (unsigned char)c;
+    }
+    
+    int index;
+    switch (key) {
+        case COMMAND_KEY('P', 'A', 'S', 'S'): index = CMD_PASS; break;
+        case COMMAND_KEY('N', 'I', 'C', 'K'): index = CMD_NICK; break;
+        case COMMAND_KEY('U', 'S', 'E', 'R'): index = CMD_USER; break;
+        case COMMAND_KEY('J', 'O', 'I', 'N'): index = CMD_JOIN; break;
+        case COMMAND_KEY('P', 'A', 'R', 'T'): index = CMD_PART; break;
+        case COMMAND_KEY('P', 'R', 'I', 'V'): index = CMD_PRIVMSG; break;
+        case COMMAND_KEY('K', 'I', 'C', 'K'): index = CMD_KICK; break;
+        case COMMAND_KEY('I', 'N', 'V', 'I'): index = CMD_INVITE; break;
+        case COMMAND_KEY('T', 'O', 'P', 'I'): index = CMD_TOPIC; break;
+        case COMMAND_KEY('M', 'O', 'D', 'E'): index = CMD_MODE; break;
+        case COMMAND_KEY('Q', 'U', 'I', 'T'): index = CMD_QUIT; break;
+        case COMMAND_KEY('P', 'I', 'N', 'G'): index = CMD_PING; break;
+        case COMMAND_KEY('P', 'O', 'N', 'G'): index = CMD_PONG; break;
+        case COMMAND_KEY('S', 'T', 'A', 'T'): index = CMD_STATS; break;
+        default: return -1;
+    }
+    if (!command.equalsIgnoreCase(commandTable[index].name)) {
+        return -1;
+    }
+    return index;
+}
+
+// the line is only split into views, the handlers copy what they keep.
+// parsing and the checks below only touch the sender; the state lock is
+// taken per command, shared for the ones that only read nick/channel state
+void Server::parseCommand(Client* client, const char* line, size_t length) {
+    IrcMessage msg;
+    if (!IrcMessage::parse(line, length, msg)) return;
+    
+    int index = findCommand(msg.command);
+    if (index < 0) {
         if (client->getRegistered()) {
-            client->queueMessage("421 " + client->getNickname() + " " + command + " :Unknown command");
+            sendNumeric(client, ERR_UNKNOWNCOMMAND, msg.command);
         }
+        return;
+    }
+    
+    const CommandSpec& spec = commandTable[index];
+    __atomic_add_fetch(&commandStats[index].calls, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&commandStats[index].bytes, length, __ATOMIC_RELAXED);
+    
+    if (spec.rejectsRegistered && client->getRegistered()) {
+        sendNumeric(client, ERR_ALREADYREGISTRED);
+    } else if (spec.needsRegistration && !client->getRegistered()) {
+        sendNumeric(client, ERR_NOTREGISTERED);
+    } else if (msg.paramCount < spec.minParams) {
+        sendNumeric(client, ERR_NEEDMOREPARAMS, spec.name);
+    } else if (spec.readsOnly) {
+        ReadLock guard(stateLock);
+        (this->*spec.handler)(client, msg);
+    } else {
+        WriteLock guard(stateLock);
+        (this->*spec.handler)(client, msg);
     }
-    sendAllData();
 }
 
-void Server::removeMarkedClients() {
-    std::vector<int> toRemove;
-    
-    for (std::map<int, Client*>::iterator it = clients.begin(); 
-         it != clients.end(); ++it) {
-        if (it->second->isMarkedForRemoval()) {
-            it->second->sendOutputBuffer();
-            toRemove.push_back(it->first);
+// only the clients marked since the last iteration are visited
+void Server::removeMarkedClients(Reactor* reactor) {
+    bool completesIo = reactor->getBackend()->completesIo();
+    Client* client;
+    while ((client = reactor->takeRemoval()) != NULL) {
+        if (!completesIo) {
+            client->sendOutputBuffer();
+        } else if (client->hasDataToSend() && !lingerClient(reactor, client)) {
+            continue;
         }
+        removeClient(reactor, client->getFd());
     }
-    
-    for (size_t i = 0; i < toRemove.size(); i++) {
-        removeClient(toRemove[i]);
+}
+
+// completion backends own the head of the queue while a send is in flight,
+// and closing the fd would cancel it together with the ERROR queued behind.
+// the client leaves its channels now and keeps the socket until its last
+// lines are sent (handleSendCompleted puts it back on the removal list) or
+// the deadline passes. returns true once it is time to close
+bool Server::lingerClient(Reactor* reactor, Client* client) {
+    unsigned long now = monotonicMs();
+    if (client->getLingerUntil() == 0) {
+        {
+            WriteLock guard(stateLock);
+            detachClient(client);
+        }
+        client->setLingerUntil(now + LINGER_MS);
+        reactor->getTimers().schedule(&client->getKeepalive(), LINGER_MS, now);
+        reactor->markDirty(client);
+        return false;
     }
+    return now >= client->getLingerUntil();
 }
 
 bool Server::isValidNickname(const std::string& nick) const {
@@ -369,8 +706,8 @@ bool Server::isValidNickname(const std::string& nick) const {
     return true;
 }
 
-bool Server::isValidChannelName(const std::string& name) const {
-    if (name.empty() || name.length() > 50) {
+bool Server::isValidChannelName(const StringRef& name) const {
+    if (name.empty() || name.size() > 50) {
         return false;
     }
     
@@ -378,7 +715,7 @@ bool Server::isValidChannelName(const std::string& name) const {
         return false;
     }
     
-    for (size_t i = 1; i < name.length(); i++) {
+    for (size_t i = 1; i < name.size(); i++) {
         char c = name[i];
         if (c == ' ' || c == ',' || c == ':') {
             return false;
@@ -388,181 +725,293 @@ bool Server::isValidChannelName(const std::string& name) const {
     return true;
 }
 
+void Server::keepaliveExpired(void* context) {
+    Client* client = static_cast<Client*>(context);
+    client->getReactor()->getOwner()->handleKeepalive(client);
+}
+
+// one timer per client: the registration deadline, then PINGs after a quiet
+// spell and the deadline for their answer. input only stamps lastActivity,
+// the timer looks at it when it comes up instead of being re-armed per line
+void Server::handleKeepalive(Client* client) {
+    // the linger deadline of a dropped client
+    if (client->isMarkedForRemoval()) {
+        client->setMarkedForRemoval(true);
+        return;
+    }
+    if (!client->getRegistered()) {
+        closeLink(client, "Registration timeout");
+        return;
+    }
+    TimerWheel& timers = client->getReactor()->getTimers();
+    unsigned long now = monotonicMs();
+    unsigned long idle = now - client->getLastActivity();
+    
+    // any traffic after the PING counts as an answer
+    unsigned long pingSentAt = client->getPingSentAt();
+    if (pingSentAt != 0 && client->getLastActivity() < pingSentAt) {
+        ReplyBuilder reason;
+        reason << "Ping timeout: " << idle / 1000 << " seconds";
+        closeLink(client, reason);
+        return;
+    }
+    client->setPingSentAt(0);
+    
+    unsigned long interval = config.pingInterval * 1000;
+    if (idle >= interval) {
+        client->queueMessage(ReplyBuilder() << "PING :" << serverName);
+        client->setPingSentAt(now);
+        timers.schedule(&client->getKeepalive(), config.pingTimeout * 1000, now);
+        return;
+    }
+    timers.schedule(&client->getKeepalive(), interval - idle, now);
+}
+
+// ERROR first, the client is dropped at the end of the loop iteration
+void Server::closeLink(Client* client, const StringRef& reason) {
+    LOG(INFO) << "Closing link to client " << client->getFd() << ": " << reason;
+    client->queueMessage(ReplyBuilder() << "ERROR :Closing Link: " << client->getHostname() << " ("
+                                        << reason << ")");
+    client->setMarkedForRemoval(true);
+}
+
 // handle clients
-void Server::removeClient(int clientFd) {
-    // Locate the client, copy its joined channel
-    // set for safe iteration during removal
-    std::map<int, Client*>::iterator it = clients.find(clientFd);
-    if (it == clients.end()) return;
-    Client* client = it->second;
-    const std::set<Channel*>& joinedChannels = client->getJoinedChannels();
-    std::set<Channel*> channelsCopy = joinedChannels;
-    
-    // For each channel the client joined,
-    // announce their QUIT and remove them from that channel
-    for (std::set<Channel*>::iterator chanIt = channelsCopy.begin(); 
-            chanIt != channelsCopy.end(); ++chanIt) {
-        Channel* channel = *chanIt;
-        std::string quitMsg = ":" + client->getPrefix() + " QUIT :Client disconnected";
-        channel->broadcast(quitMsg, client);
-        channel->removeMember(client);
-    }
-    
-    // Remove the client's poll entry so we stop monitoring that socket
-    for (std::vector<struct pollfd>::iterator pollIt = pollFds.begin(); 
-         pollIt != pollFds.end(); ++pollIt) {
-        if (pollIt->fd == clientFd) {
-            pollFds.erase(pollIt);
-            break;
-        }
+void Server::removeClient(Reactor* reactor, int clientFd) {
+    WriteLock guard(stateLock);
+    
+    Client* client = reactor->getConnections().find(clientFd);
+    if (!client) return;
+    // a lingering client left its channels when it was dropped
+    if (client->getLingerUntil() == 0) {
+        detachClient(client);
     }
     
-    // Delete the client object, drop it from tracking,
-    // and prune any now-empty channels
+    // unregister the socket so the backend stops monitoring it
+    reactor->removeClient(clientFd);
+    
     delete client;
-    clients.erase(it);
-    cleanupEmptyChannels();
     
-    std::cout << "Client " << clientFd << " removed" << std::endl;
+    LOG(INFO) << "Client " << clientFd << " removed";
 }
 
-void Server::cleanupEmptyChannels() {
-    // Collect names of channels that currently have no members
-    std::vector<std::string> emptyChannels;
-    for (std::map<std::string, Channel*>::iterator it = channels.begin();
-         it != channels.end(); ++it) {
-        if (it->second->isEmpty()) {
-            emptyChannels.push_back(it->first);
-        }
+// snapshot every channel the client is tied to, pending invites included,
+// so no channel keeps a dangling pointer. callers hold the state lock
+void Server::detachClient(Client* client) {
+    std::vector<Channel*> linkedChannels = client->getLinkedChannels();
+    
+    // Announce the QUIT once to everyone sharing a channel,
+    // then remove the client from each channel
+    broadcastToPeers(client, ReplyBuilder() << ":" << client->getPrefix() << " QUIT :Client disconnected");
+    for (size_t i = 0; i < linkedChannels.size(); i++) {
+        leaveChannel(linkedChannels[i], client);
     }
     
-    // Delete each empty channel and log its removal from the server list
-    for (size_t i = 0; i < emptyChannels.size(); i++) {
-        std::map<std::string, Channel*>::iterator it = channels.find(emptyChannels[i]);
-        if (it != channels.end()) {
-            delete it->second;
-            channels.erase(it);
-            std::cout << "Channel " << emptyChannels[i] << " removed" << std::endl;
-        }
+    // Free the nick for the next user
+    if (!client->getNickname().empty()) {
+        nicknames.erase(client->getNickname(), client);
     }
 }
 
-Client* Server::getClientByNickname(const std::string& nickname) {
-    for (std::map<int, Client*>::iterator it = clients.begin(); it != clients.end(); ++it) {
-        std::string clientNick = it->second->getNickname();
-        std::string searchNick = nickname;
-        
-        for (size_t i = 0; i < clientNick.length(); i++) {
-            clientNick[i] = std::tolower(clientNick[i]);
-        }
-        for (size_t i = 0; i < searchNick.length(); i++) {
-            searchNick[i] = std::tolower(searchNick[i]);
-        }
-        
-        if (clientNick == searchNick) {
-            return it->second;
-        }
+// a line about client (QUIT, NICK) for everyone sharing at least one channel
+// with it: serialized once, and the epoch stamp on each peer makes sure a
+// peer met again in another channel is skipped. callers hold the state lock
+void Server::broadcastToPeers(Client* client, const StringRef& message) {
+    unsigned long epoch = ++fanoutEpoch;
+    client->markFanout(epoch);
+    
+    SharedBuffer* buffer = SharedBuffer::fromLine(message);
+    Fanout fanout(buffer);
+    std::vector<Channel*> joinedChannels = client->getJoinedChannels();
+    for (size_t i = 0; i < joinedChannels.size(); i++) {
+        joinedChannels[i]->broadcastOnce(fanout, epoch);
+    }
+    fanout.post();
+    buffer->release();
+}
+
+// a numeric from the table in Numerics.cpp, addressed to the client's nick
+// or "*" before it has one. the pieces go straight into the send queue
+void Server::sendNumeric(Client* client, Numeric numeric, const StringRef& first,
+                         const StringRef& second, const StringRef& third) {
+    StringRef args[NumericReply::MAX_ARGS] = { first, second, third };
+    StringRef pieces[NumericReply::MAX_PIECES];
+    size_t total = 0;
+    const std::string& nick = client->getNickname();
+    StringRef target = nick.empty() ? StringRef("*") : StringRef(nick);
+    int count = NumericReply::format(numeric, serverName, target, args, pieces, total);
+    client->queuePieces(pieces, count, total);
+}
+
+// 353 lines kept under the line limit, then the 366 that ends the list
+void Server::sendNames(Client* client, Channel* channel) {
+    const std::string& nick = client->getNickname();
+    // ":<server> 353 <nick> = <channel> :" and the CRLF
+    size_t overhead = serverName.length() + nick.length() + channel->getName().length() + 13;
+    size_t maxLength = InputBuffer::MAX_LINE - overhead;
+    size_t position = 0;
+    bool more = true;
+    while (more) {
+        ReplyBuilder names;
+        more = channel->appendNames(names, position, maxLength);
+        if (names.size() == 0)
+            break;
+        sendNumeric(client, RPL_NAMREPLY, channel->getName(), names);
     }
-    return NULL;
+    sendNumeric(client, RPL_ENDOFNAMES, channel->getName());
 }
 
-Channel* Server::getChannel(const std::string& channelName) {
-    std::string lowerName = channelName;
-    for (size_t i = 0; i < lowerName.length(); i++) {
-        lowerName[i] = std::tolower(lowerName[i]);
+// every path that drops a member comes through here, so a channel is
+// reclaimed the moment its last member leaves instead of by a full scan
+void Server::leaveChannel(Channel* channel, Client* client) {
+    channel->removeMember(client);
+    if (channel->isEmpty()) {
+        retireChannel(channel);
     }
-    
-    for (std::map<std::string, Channel*>::iterator it = channels.begin();
-         it != channels.end(); ++it) {
-        std::string existingName = it->first;
-        for (size_t i = 0; i < existingName.length(); i++) {
-            existingName[i] = std::tolower(existingName[i]);
-        }
-        if (existingName == lowerName) {
-            return it->second;
-        }
+}
+
+// with --channel-grace the emptied channel is parked for reuse instead of freed,
+// so a channel that keeps emptying and refilling is not reallocated each time
+void Server::retireChannel(Channel* channel) {
+    channel->reset();
+    if (config.channelGrace == 0) {
+        destroyChannel(channel);
+        return;
+    }
+    channel->emptiedAt = monotonicMs();
+    idleChannels.pushBack(channel);
+    Reactor* reactor = Reactor::current();
+    if (reactor && !reactor->getChannelSweep().armed) {
+        reactor->getTimers().schedule(&reactor->getChannelSweep(), config.channelGrace * 1000, monotonicMs());
     }
-    return NULL;
 }
 
+// deferred task on the reactor that parked a channel; the list is shared, so it
+// also frees channels parked by other reactors, and re-arms for the next one
+void Server::channelSweepExpired(void* context) {
+    Reactor* reactor = static_cast<Reactor*>(context);
+    reactor->getOwner()->sweepIdleChannels(reactor);
+}
+
+void Server::sweepIdleChannels(Reactor* reactor) {
+    WriteLock guard(stateLock);
+    unsigned long now = monotonicMs();
+    reclaimIdleChannels(now);
+    Channel* oldest = idleChannels.front();
+    if (oldest) {
+        // the oldest is not due yet, or it would have been reclaimed
+        unsigned long wait = oldest->emptiedAt + config.channelGrace * 1000UL - now;
+        reactor->getTimers().schedule(&reactor->getChannelSweep(), wait, now);
+    }
+}
+
+// the idle list is ordered by emptiedAt, expired channels sit at its front.
+// the monotonic clock keeps that order when the wall clock is stepped
+void Server::reclaimIdleChannels(unsigned long now) {
+    Channel* channel;
+    while ((channel = idleChannels.front()) != NULL &&
+           now - channel->emptiedAt >= config.channelGrace * 1000UL) {
+        idleChannels.remove(channel);
+        destroyChannel(channel);
+    }
+}
+
+void Server::destroyChannel(Channel* channel) {
+    LOG(INFO) << "Channel " << channel->getName() << " removed";
+    channels.erase(channel->getName(), channel);
+    delete channel;
+}
+
+// nicks of all reactors' clients, compared under RFC 1459 casemapping.
+// callers hold the state lock, so the index does not change meanwhile
+Client* Server::getClientByNickname(const StringRef& nickname) {
+    return nicknames.find(nickname);
+}
+
+// channels are indexed under their casefolded name, the Channel keeps the display case
+// channels parked for reuse stay indexed but do not exist for clients
+Channel* Server::getChannel(const StringRef& channelName) {
+    Channel* channel = channels.find(channelName);
+    if (channel && idleChannels.contains(channel)) {
+        return NULL;
+    }
+    return channel;
+}
+
+// takes over a parked channel of that name if there is one;
+// NULL when a live channel holds the name under casemapping
 Channel* Server::createChannel(const std::string& channelName, Client* creator) {
-    Channel* channel = new Channel(channelName);
-    channels[channelName] = channel;
+    Channel* channel = channels.find(channelName);
+    if (channel) {
+        if (!idleChannels.contains(channel)) {
+            return NULL;
+        }
+        idleChannels.remove(channel);
+        channel->setName(channelName);
+    } else {
+        channel = new Channel(channelName);
+        channels.insert(channelName, channel);
+    }
     channel->addMember(creator);
     channel->addOperator(creator);
     return channel;
 }
 
 // commands
-void Server::cmdPass(Client* client, const std::vector<std::string>& tokens) {
-    if (client->getRegistered()) {
-        client->queueMessage("462 :You may not reregister");
-        return;
-    }
-    
-    if (tokens.size() < 2) {
-        client->queueMessage("461 PASS :Not enough parameters");
-        return;
-    }
-    
-    if (tokens[1] == password) {
+void Server::cmdPass(Client* client, const IrcMessage& msg) {
+    if (msg.params[0] == password) {
         client->setAuthenticated(true);
     } else {
-        client->queueMessage("464 :Password incorrect");
+        sendNumeric(client, ERR_PASSWDMISMATCH);
     }
 }
 
-void Server::cmdNick(Client* client, const std::vector<std::string>& tokens) {
-    if (tokens.size() < 2) {
-        client->queueMessage("431 :No nickname given");
+void Server::cmdNick(Client* client, const IrcMessage& msg) {
+    if (msg.paramCount < 1) {
+        sendNumeric(client, ERR_NONICKNAMEGIVEN);
         return;
     }
     
-    std::string newNick = tokens[1];
+    std::string newNick = msg.params[0].str();
     
     if (!isValidNickname(newNick)) {
-        client->queueMessage("432 " + newNick + " :Erroneous nickname");
+        sendNumeric(client, ERR_ERRONEUSNICKNAME, newNick);
         return;
     }
     
     Client* existing = getClientByNickname(newNick);
     if (existing != NULL && existing != client) {
-        client->queueMessage("433 * " + newNick + " :Nickname is already in use");
+        sendNumeric(client, ERR_NICKNAMEINUSE, newNick);
         return;
     }
     
-    std::string oldNick = client->getNickname();
+    // the NICK line still names the old nick, so it is built before the change
+    bool announce = client->getRegistered();
+    ReplyBuilder nickMsg;
+    if (announce) {
+        const std::string& oldNick = client->getNickname();
+        nickMsg << ":" << (oldNick.empty() ? newNick : oldNick) << " NICK :" << newNick;
+    }
+    
+    if (!client->getNickname().empty()) {
+        nicknames.erase(client->getNickname(), client);
+    }
     client->setNickname(newNick);
+    nicknames.insert(newNick, client);
     
     // if already registered, notify about nick change
-    if (client->getRegistered()) {
-        std::string msg = ":" + (oldNick.empty() ? newNick : oldNick) + " NICK :" + newNick;
-        client->queueMessage(msg);
+    if (announce) {
+        client->queueMessage(nickMsg);
         
-        // notify all channels this user is in
-        const std::set<Channel*>& joinedChannels = client->getJoinedChannels();
-        for (std::set<Channel*>::const_iterator it = joinedChannels.begin();
-             it != joinedChannels.end(); ++it) {
-            (*it)->broadcast(msg, client);
-        }
+        // notify everyone sharing a channel, once each
+        broadcastToPeers(client, nickMsg);
     }
     
     tryCompleteRegistration(client);
 }
 
-void Server::cmdUser(Client* client, const std::vector<std::string>& tokens) {
-    if (client->getRegistered()) {
-        client->queueMessage("462 :You may not reregister");
-        return;
-    }
-    
-    if (tokens.size() < 5) {
-        client->queueMessage("461 USER :Not enough parameters");
-        return;
-    }
-    
-    client->setUsername(tokens[1]);
-    client->setRealname(tokens[4]);
+void Server::cmdUser(Client* client, const IrcMessage& msg) {
+    client->setUsername(msg.params[0].str());
+    client->setRealname(msg.params[3].str());
     
     tryCompleteRegistration(client);
 }
@@ -581,488 +1030,464 @@ void Server::tryCompleteRegistration(Client* client) {
     }
     
     client->setRegistered(true);
-    
-    std::string nick = client->getNickname();
-    client->queueMessage("001 " + nick + " :Welcome to the Internet Relay Network " + client->getPrefix());
-    client->queueMessage("002 " + nick + " :Your host is " + serverName + ", running the latest version");
-    client->queueMessage("003 " + nick + " :This server was created today");
-    client->queueMessage("004 " + nick + " :" + serverName + " o itkol");
-    client->queueMessage("375 " + nick + " :" + serverName + " Message of the Day -");
-    client->queueMessage("372 " + nick + " :*Happy Christmas* and welcome to our little IRC server!");
-    client->queueMessage("376 " + nick + " :End of /MOTD command");
+    applySendQClass(client);
+    client->getReactor()->getTimers().schedule(&client->getKeepalive(), config.pingInterval * 1000, monotonicMs());
+    
+    sendNumeric(client, RPL_WELCOME, client->getPrefix());
+    sendNumeric(client, RPL_YOURHOST, serverName, serverVersion);
+    sendNumeric(client, RPL_CREATED, createdAt);
+    sendNumeric(client, RPL_MYINFO, serverName, serverVersion);
+    sendNumeric(client, RPL_MOTDSTART, serverName);
+    sendNumeric(client, RPL_MOTD, "*Happy Christmas* and welcome to our little IRC server!");
+    sendNumeric(client, RPL_ENDOFMOTD);
 }
 
-void Server::cmdJoin(Client* client, const std::vector<std::string>& tokens) {
-    if (!client->getRegistered()) {
-        client->queueMessage("451 :You have not registered");
-        return;
+// registered clients get the larger user SendQ, the soft mark is a share of it
+void Server::applySendQClass(Client* client) {
+    size_t limit = client->getRegistered() ? config.sendqUser : config.sendqUnregistered;
+    client->setSendQLimit(limit, limit / 100 * config.sendqSoftPercent);
+}
+
+// takes the next comma-separated item off the front of list; empty items
+// between commas count, a trailing comma does not start one
+static bool nextListItem(StringRef& list, StringRef& item) {
+    item = StringRef();
+    if (list.empty()) {
+        return false;
     }
-    
-    if (tokens.size() < 2) {
-        client->queueMessage("461 JOIN :Not enough parameters");
-        return;
+    const char* comma = static_cast<const char*>(std::memchr(list.data, ',', list.length));
+    if (!comma) {
+        item = list;
+        list = StringRef();
+        return true;
     }
+    item = StringRef(list.data, comma - list.data);
+    list = StringRef(comma + 1, list.length - item.length - 1);
+    return true;
+}
+
+void Server::cmdJoin(Client* client, const IrcMessage& msg) {
+    StringRef channelList = msg.params[0];
+    StringRef keyList = (msg.paramCount >= 2) ? msg.params[1] : StringRef();
     
-    std::string channelList = tokens[1];
-    std::string keyList = (tokens.size() >= 3) ? tokens[2] : "";
-    
-    std::vector<std::string> channelNames;
-    std::vector<std::string> keys;
-    
-    // split channels
-    std::istringstream chanStream(channelList);
-    std::string chanToken;
-    while (std::getline(chanStream, chanToken, ',')) {
-        if (!chanToken.empty()) {
-            channelNames.push_back(chanToken);
+    StringRef channelName;
+    while (nextListItem(channelList, channelName)) {
+        if (channelName.empty()) {
+            continue;
         }
-    }
-    
-    // split keys
-    std::istringstream keyStream(keyList);
-    std::string keyToken;
-    while (std::getline(keyStream, keyToken, ',')) {
-        keys.push_back(keyToken);
-    }
-    
-    for (size_t i = 0; i < channelNames.size(); i++) {
-        std::string channelName = channelNames[i];
-        std::string key = (i < keys.size()) ? keys[i] : "";
+        // keys pair up with the non-empty channel names in order
+        StringRef key;
+        nextListItem(keyList, key);
         
         if (!isValidChannelName(channelName)) {
-            client->queueMessage("403 " + channelName + " :No such channel");
+            sendNumeric(client, ERR_NOSUCHCHANNEL, channelName);
             continue;
         }
         
         Channel* channel = getChannel(channelName);
         
         if (!channel) {
-            channel = createChannel(channelName, client);
+            channel = createChannel(channelName.str(), client);
+            if (!channel) {
+                continue;
+            }
         } else {
             if (channel->isMember(client)) {
                 continue;
             }
             if (channel->getInviteOnly() && !channel->isInvited(client)) {
-                client->queueMessage("473 " + channelName + " :Cannot join channel (+i)");
+                sendNumeric(client, ERR_INVITEONLYCHAN, channelName);
                 continue;
             }
             if (channel->getHasUserLimit() && 
                 channel->getMemberCount() >= channel->getUserLimit()) {
-                client->queueMessage("471 " + channelName + " :Cannot join channel (+l)");
+                sendNumeric(client, ERR_CHANNELISFULL, channelName);
                 continue;
             }
             if (channel->getHasKey() && key != channel->getKey()) {
-                client->queueMessage("475 " + channelName + " :Cannot join channel (+k)");
+                sendNumeric(client, ERR_BADCHANNELKEY, channelName);
                 continue;
             }
             channel->addMember(client);
         }
         
         // inform all members about joining
-        std::string joinMsg = ":" + client->getPrefix() + " JOIN " + channel->getName();
+        ReplyBuilder joinMsg;
+        joinMsg << ":" << client->getPrefix() << " JOIN " << channel->getName();
         channel->broadcast(joinMsg, NULL);
         
         // send topic
         if (!channel->getTopic().empty()) {
-            client->queueMessage("332 " + client->getNickname() + " " + channel->getName() + 
-                              " :" + channel->getTopic());
+            sendNumeric(client, RPL_TOPIC, channel->getName(), channel->getTopic());
         }
         
         // send names list
-        client->queueMessage(channel->getNamesReply(client->getNickname()));
-        client->queueMessage("366 " + client->getNickname() + " " + channel->getName() + 
-                          " :End of /NAMES list");
+        sendNames(client, channel);
     }
 }
 
-void Server::cmdPart(Client* client, const std::vector<std::string>& tokens) {
-    if (!client->getRegistered()) {
-        client->queueMessage("451 :You have not registered");
-        return;
-    }
+void Server::cmdPart(Client* client, const IrcMessage& msg) {
+    StringRef reason = (msg.paramCount >= 2) ? msg.params[1] : StringRef(client->getNickname());
     
-    if (tokens.size() < 2) {
-        client->queueMessage("461 PART :Not enough parameters");
-        return;
-    }
-    
-    std::string reason = (tokens.size() >= 3) ? tokens[2] : client->getNickname();
-    
-    std::istringstream chanStream(tokens[1]);
-    std::string channelName;
-    
-    while (std::getline(chanStream, channelName, ',')) {
+    StringRef channelList = msg.params[0];
+    StringRef channelName;
+    while (nextListItem(channelList, channelName)) {
         if (channelName.empty()) continue;
         
         Channel* channel = getChannel(channelName);
         if (!channel) {
-            client->queueMessage("403 " + channelName + " :No such channel");
+            sendNumeric(client, ERR_NOSUCHCHANNEL, channelName);
             continue;
         }
         if (!channel->isMember(client)) {
-            client->queueMessage("442 " + channelName + " :You're not on that channel");
+            sendNumeric(client, ERR_NOTONCHANNEL, channelName);
             continue;
         }
         
         // inform all members about leaving
-        std::string partMsg = ":" + client->getPrefix() + " PART " + channel->getName() + " :" + reason;
+        ReplyBuilder partMsg;
+        partMsg << ":" << client->getPrefix() << " PART " << channel->getName() << " :" << reason;
         channel->broadcast(partMsg, NULL);
         
-        channel->removeMember(client);
+        leaveChannel(channel, client);
     }
-    
-    cleanupEmptyChannels();
 }
 
-void Server::cmdPrivmsg(Client* client, const std::vector<std::string>& tokens) {
-    if (!client->getRegistered()) {
-        client->queueMessage("451 :You have not registered");
+void Server::cmdPrivmsg(Client* client, const IrcMessage& msg) {
+    if (msg.paramCount < 1) {
+        sendNumeric(client, ERR_NORECIPIENT, "PRIVMSG");
         return;
     }
-    if (tokens.size() < 2) {
-        client->queueMessage("411 :No recipient given (PRIVMSG)");
-        return;
-    }
-    if (tokens.size() < 3) {
-        client->queueMessage("412 :No text to send");
+    if (msg.paramCount < 2) {
+        sendNumeric(client, ERR_NOTEXTTOSEND);
         return;
     }
     
-    std::string target = tokens[1];
-    std::string message = tokens[2];
+    const StringRef& target = msg.params[0];
+    const StringRef& message = msg.params[1];
     
-    if (target[0] == '#' || target[0] == '&') {
+    if (!target.empty() && (target[0] == '#' || target[0] == '&')) {
         Channel* channel = getChannel(target);
         if (!channel) {
-            client->queueMessage("403 " + target + " :No such channel");
+            sendNumeric(client, ERR_NOSUCHCHANNEL, target);
             return;
         }
         if (!channel->isMember(client)) {
-            client->queueMessage("404 " + target + " :Cannot send to channel");
+            sendNumeric(client, ERR_CANNOTSENDTOCHAN, target);
             return;
         }
         
-        std::string msg = ":" + client->getPrefix() + " PRIVMSG " + channel->getName() + " :" + message;
-        channel->broadcast(msg, client);
+        ReplyBuilder header;
+        header << ":" << client->getPrefix() << " PRIVMSG " << channel->getName() << " :";
+        // channel chatter is the first thing a congested member loses
+        channel->broadcast(header, message, client, true);
     } else {
         Client* targetClient = getClientByNickname(target);
         if (!targetClient) {
-            client->queueMessage("401 " + target + " :No such nick/channel");
+            sendNumeric(client, ERR_NOSUCHNICK, target);
             return;
         }
         
-        std::string msg = ":" + client->getPrefix() + " PRIVMSG " + targetClient->getNickname() + " :" + message;
-        targetClient->queueMessage(msg);
+        ReplyBuilder header;
+        header << ":" << client->getPrefix() << " PRIVMSG " << targetClient->getNickname() << " :";
+        targetClient->queueMessage(header, message);
     }
 }
 
-void Server::cmdKick(Client* client, const std::vector<std::string>& tokens) {
-    if (!client->getRegistered()) {
-        client->queueMessage("451 :You have not registered");
-        return;
-    }
-    if (tokens.size() < 3) {
-        client->queueMessage("461 KICK :Not enough parameters");
-        return;
-    }
-    
-    std::string channelName = tokens[1];
-    std::string targetNick = tokens[2];
-    std::string reason = (tokens.size() >= 4) ? tokens[3] : client->getNickname();
+void Server::cmdKick(Client* client, const IrcMessage& msg) {
+    const StringRef& channelName = msg.params[0];
+    const StringRef& targetNick = msg.params[1];
+    StringRef reason = (msg.paramCount >= 3) ? msg.params[2] : StringRef(client->getNickname());
     
     Channel* channel = getChannel(channelName);
     if (!channel) {
-        client->queueMessage("403 " + channelName + " :No such channel");
+        sendNumeric(client, ERR_NOSUCHCHANNEL, channelName);
         return;
     }
     if (!channel->isMember(client)) {
-        client->queueMessage("442 " + channelName + " :You're not on that channel");
+        sendNumeric(client, ERR_NOTONCHANNEL, channelName);
         return;
     }
     if (!channel->isOperator(client)) {
-        client->queueMessage("482 " + channelName + " :You're not channel operator");
+        sendNumeric(client, ERR_CHANOPRIVSNEEDED, channelName);
         return;
     }
     
     Client* targetClient = getClientByNickname(targetNick);
     if (!targetClient || !channel->isMember(targetClient)) {
-        client->queueMessage("441 " + targetNick + " " + channelName + " :They aren't on that channel");
+        sendNumeric(client, ERR_USERNOTINCHANNEL, targetNick, channelName);
         return;
     }
     
-    std::string kickMsg = ":" + client->getPrefix() + " KICK " + channel->getName() + " " + 
-                         targetClient->getNickname() + " :" + reason;
+    ReplyBuilder kickMsg;
+    kickMsg << ":" << client->getPrefix() << " KICK " << channel->getName() << " "
+            << targetClient->getNickname() << " :" << reason;
     channel->broadcast(kickMsg, NULL);
     
-    channel->removeMember(targetClient);
-    cleanupEmptyChannels();
+    leaveChannel(channel, targetClient);
 }
 
-void Server::cmdInvite(Client* client, const std::vector<std::string>& tokens) {
-    if (!client->getRegistered()) {
-        client->queueMessage("451 :You have not registered");
-        return;
-    }
-    if (tokens.size() < 3) {
-        client->queueMessage("461 INVITE :Not enough parameters");
-        return;
-    }
-    
-    std::string targetNick = tokens[1];
-    std::string channelName = tokens[2];
+void Server::cmdInvite(Client* client, const IrcMessage& msg) {
+    const StringRef& targetNick = msg.params[0];
+    const StringRef& channelName = msg.params[1];
     
     Channel* channel = getChannel(channelName);
     if (!channel) {
-        client->queueMessage("403 " + channelName + " :No such channel");
+        sendNumeric(client, ERR_NOSUCHCHANNEL, channelName);
         return;
     }
     if (!channel->isMember(client)) {
-        client->queueMessage("442 " + channelName + " :You're not on that channel");
+        sendNumeric(client, ERR_NOTONCHANNEL, channelName);
         return;
     }
     if (channel->getInviteOnly() && !channel->isOperator(client)) {
-        client->queueMessage("482 " + channelName + " :You're not channel operator");
+        sendNumeric(client, ERR_CHANOPRIVSNEEDED, channelName);
         return;
     }
     
     Client* targetClient = getClientByNickname(targetNick);
     if (!targetClient) {
-        client->queueMessage("401 " + targetNick + " :No such nick/channel");
+        sendNumeric(client, ERR_NOSUCHNICK, targetNick);
         return;
     }
     
     if (channel->isMember(targetClient)) {
-        client->queueMessage("443 " + targetNick + " " + channelName + " :is already on channel");
+        sendNumeric(client, ERR_USERONCHANNEL, targetNick, channelName);
         return;
     }
     
     channel->addToInviteList(targetClient);
-    client->queueMessage("341 " + client->getNickname() + " " + targetClient->getNickname() + 
-                        " " + channel->getName());
-    targetClient->queueMessage(":" + client->getPrefix() + " INVITE " + targetClient->getNickname() + 
-                              " :" + channel->getName());
+    sendNumeric(client, RPL_INVITING, targetClient->getNickname(), channel->getName());
+    targetClient->queueMessage(ReplyBuilder() << ":" << client->getPrefix() << " INVITE "
+                                              << targetClient->getNickname() << " :"
+                                              << channel->getName());
 }
 
-void Server::cmdTopic(Client* client, const std::vector<std::string>& tokens) {
-    if (!client->getRegistered()) {
-        client->queueMessage("451 :You have not registered");
-        return;
-    }
-    if (tokens.size() < 2) {
-        client->queueMessage("461 TOPIC :Not enough parameters");
-        return;
-    }
-    
-    std::string channelName = tokens[1];
+void Server::cmdTopic(Client* client, const IrcMessage& msg) {
+    const StringRef& channelName = msg.params[0];
     Channel* channel = getChannel(channelName);
     
     if (!channel) {
-        client->queueMessage("403 " + channelName + " :No such channel");
+        sendNumeric(client, ERR_NOSUCHCHANNEL, channelName);
         return;
     }
     if (!channel->isMember(client)) {
-        client->queueMessage("442 " + channelName + " :You're not on that channel");
+        sendNumeric(client, ERR_NOTONCHANNEL, channelName);
         return;
     }
     
     // view and set topic
-    if (tokens.size() == 2) {
+    if (msg.paramCount == 1) {
         if (channel->getTopic().empty()) {
-            client->queueMessage("331 " + client->getNickname() + " " + channel->getName() + 
-                              " :No topic is set");
+            sendNumeric(client, RPL_NOTOPIC, channel->getName());
         } else {
-            client->queueMessage("332 " + client->getNickname() + " " + channel->getName() + 
-                              " :" + channel->getTopic());
+            sendNumeric(client, RPL_TOPIC, channel->getName(), channel->getTopic());
         }
     } else {
         if (channel->getTopicRestricted() && !channel->isOperator(client)) {
-            client->queueMessage("482 " + channelName + " :You're not channel operator");
+            sendNumeric(client, ERR_CHANOPRIVSNEEDED, channelName);
             return;
         }
         
-        std::string newTopic = tokens[2];
+        std::string newTopic = msg.params[1].str();
         channel->setTopic(newTopic, client->getNickname());
         
-        std::string topicMsg = ":" + client->getPrefix() + " TOPIC " + channel->getName() + " :" + newTopic;
+        ReplyBuilder topicMsg;
+        topicMsg << ":" << client->getPrefix() << " TOPIC " << channel->getName() << " :" << newTopic;
         channel->broadcast(topicMsg, NULL);
     }
 }
 
-void Server::cmdMode(Client* client, const std::vector<std::string>& tokens) {
-    if (!client->getRegistered()) {
-        client->queueMessage("451 :You have not registered");
-        return;
-    }
-    if (tokens.size() < 2) {
-        client->queueMessage("461 MODE :Not enough parameters");
-        return;
-    }
-    
-    std::string target = tokens[1];
+void Server::cmdMode(Client* client, const IrcMessage& msg) {
+    const StringRef& target = msg.params[0];
     
     // change mode for channel
-    if (target[0] == '#' || target[0] == '&') {
+    if (!target.empty() && (target[0] == '#' || target[0] == '&')) {
         Channel* channel = getChannel(target);
         
         if (!channel) {
-            client->queueMessage("403 " + target + " :No such channel");
+            sendNumeric(client, ERR_NOSUCHCHANNEL, target);
             return;
         }
         
-        if (tokens.size() == 2) {
-            client->queueMessage("324 " + client->getNickname() + " " + channel->getName() + 
-                              " " + channel->getModeString());
+        if (msg.paramCount == 1) {
+            ReplyBuilder modes;
+            channel->appendModes(modes);
+            sendNumeric(client, RPL_CHANNELMODEIS, channel->getName(), modes);
             return;
         }
         
         if (!channel->isMember(client)) {
-            client->queueMessage("442 " + target + " :You're not on that channel");
+            sendNumeric(client, ERR_NOTONCHANNEL, target);
             return;
         }
         
         if (!channel->isOperator(client)) {
-            client->queueMessage("482 " + target + " :You're not channel operator");
+            sendNumeric(client, ERR_CHANOPRIVSNEEDED, target);
             return;
         }
         
-        std::string modeStr = tokens[2];
+        const StringRef& modeStr = msg.params[1];
         bool adding = true;
-        size_t paramIndex = 3;
+        size_t paramIndex = 2;
         
-        std::string appliedModes = "";
-        std::string appliedParams = "";
-        bool currentAdding = true;
+        // what actually changed, a sign only where it flips: "+it-k key"
+        ReplyBuilder appliedModes;
+        ReplyBuilder appliedParams;
+        char appliedSign = 0;
         
-        for (size_t i = 0; i < modeStr.length(); i++) {
+        for (size_t i = 0; i < modeStr.size(); i++) {
             char mode = modeStr[i];
+            bool applied = false;
             
-            if (mode == '+') {
-                adding = true;
-                if (currentAdding != adding) {
-                    appliedModes += '+';
-                    currentAdding = adding;
-                }
-            } else if (mode == '-') {
-                adding = false;
-                if (currentAdding != adding) {
-                    appliedModes += '-';
-                    currentAdding = adding;
-                }
+            if (mode == '+' || mode == '-') {
+                adding = (mode == '+');
             } else if (mode == 'i') {
                 channel->setInviteOnly(adding);
-                if (appliedModes.empty() || (appliedModes[appliedModes.length()-1] != '+' && 
-                    appliedModes[appliedModes.length()-1] != '-')) {
-                    appliedModes += (adding ? "+" : "-");
-                }
-                appliedModes += 'i';
+                applied = true;
             } else if (mode == 't') {
                 channel->setTopicRestricted(adding);
-                if (appliedModes.empty() || (appliedModes[appliedModes.length()-1] != '+' && 
-                    appliedModes[appliedModes.length()-1] != '-')) {
-                    appliedModes += (adding ? "+" : "-");
-                }
-                appliedModes += 't';
+                applied = true;
             } else if (mode == 'k') {
                 if (adding) {
-                    if (paramIndex < tokens.size()) {
-                        channel->setKey(tokens[paramIndex]);
-                        if (appliedModes.empty() || (appliedModes[appliedModes.length()-1] != '+' && 
-                            appliedModes[appliedModes.length()-1] != '-')) {
-                            appliedModes += "+";
-                        }
-                        appliedModes += 'k';
-                        appliedParams += " " + tokens[paramIndex];
+                    if (paramIndex < msg.paramCount) {
+                        channel->setKey(msg.params[paramIndex].str());
+                        appliedParams << ' ' << msg.params[paramIndex];
+                        applied = true;
                         paramIndex++;
                     }
                 } else {
                     channel->setKey("");
-                    if (appliedModes.empty() || (appliedModes[appliedModes.length()-1] != '+' && 
-                        appliedModes[appliedModes.length()-1] != '-')) {
-                        appliedModes += "-";
-                    }
-                    appliedModes += 'k';
+                    applied = true;
                 }
-            } else if (mode == 'o') {
-                if (paramIndex < tokens.size()) {
-                    Client* targetClient = getClientByNickname(tokens[paramIndex]);
+            } else if (mode == 'o' || mode == 'v') {
+                if (paramIndex < msg.paramCount) {
+                    Client* targetClient = getClientByNickname(msg.params[paramIndex]);
                     if (targetClient && channel->isMember(targetClient)) {
-                        if (adding) {
+                        if (mode == 'o' && adding) {
                             channel->addOperator(targetClient);
-                        } else {
+                        } else if (mode == 'o') {
                             channel->removeOperator(targetClient);
+                        } else if (adding) {
+                            channel->addVoice(targetClient);
+                        } else {
+                            channel->removeVoice(targetClient);
                         }
-                        if (appliedModes.empty() || (appliedModes[appliedModes.length()-1] != '+' && 
-                            appliedModes[appliedModes.length()-1] != '-')) {
-                            appliedModes += (adding ? "+" : "-");
-                        }
-                        appliedModes += 'o';
-                        appliedParams += " " + tokens[paramIndex];
+                        appliedParams << ' ' << msg.params[paramIndex];
+                        applied = true;
                     }
                     paramIndex++;
                 }
             } else if (mode == 'l') {
                 if (adding) {
-                    if (paramIndex < tokens.size()) {
-                        int limit = std::atoi(tokens[paramIndex].c_str());
+                    if (paramIndex < msg.paramCount) {
+                        int limit = std::atoi(msg.params[paramIndex].str().c_str());
                         if (limit > 0) {
                             channel->setUserLimit(limit);
-                            if (appliedModes.empty() || (appliedModes[appliedModes.length()-1] != '+' && 
-                                appliedModes[appliedModes.length()-1] != '-')) {
-                                appliedModes += "+";
-                            }
-                            appliedModes += 'l';
-                            appliedParams += " " + tokens[paramIndex];
+                            appliedParams << ' ' << msg.params[paramIndex];
+                            applied = true;
                         }
                         paramIndex++;
                     }
                 } else {
                     channel->setUserLimit(0);
-                    if (appliedModes.empty() || (appliedModes[appliedModes.length()-1] != '+' && 
-                        appliedModes[appliedModes.length()-1] != '-')) {
-                        appliedModes += "-";
-                    }
-                    appliedModes += 'l';
+                    applied = true;
                 }
             } else {
-                client->queueMessage("472 " + std::string(1, mode) + " :is unknown mode char to me");
+                sendNumeric(client, ERR_UNKNOWNMODE, StringRef(modeStr.data + i, 1));
+            }
+            
+            if (applied) {
+                char sign = adding ? '+' : '-';
+                if (sign != appliedSign) {
+                    appliedModes << sign;
+                    appliedSign = sign;
+                }
+                appliedModes << mode;
             }
         }
         
-        if (!appliedModes.empty() && appliedModes != "+" && appliedModes != "-") {
-            std::string modeMsg = ":" + client->getPrefix() + " MODE " + channel->getName() + 
-                                 " " + appliedModes + appliedParams;
+        if (appliedModes.size() > 0) {
+            ReplyBuilder modeMsg;
+            modeMsg << ":" << client->getPrefix() << " MODE " << channel->getName() << " "
+                    << appliedModes << appliedParams;
             channel->broadcast(modeMsg, NULL);
         }
     // no user modes needed according to subject
     } else {
-        client->queueMessage("502 :Cannot change mode for other users");
+        sendNumeric(client, ERR_USERSDONTMATCH);
     }
 }
 
-void Server::cmdQuit(Client* client, const std::vector<std::string>& tokens) {
-    std::string reason = (tokens.size() >= 2) ? tokens[1] : "Client Quit";
+void Server::cmdQuit(Client* client, const IrcMessage& msg) {
+    StringRef reason = (msg.paramCount >= 1) ? msg.params[0] : StringRef("Client Quit");
     
-    const std::set<Channel*>& joinedChannels = client->getJoinedChannels();
-    std::set<Channel*> channelsCopy = joinedChannels;
+    broadcastToPeers(client, ReplyBuilder() << ":" << client->getPrefix() << " QUIT :" << reason);
     
-    for (std::set<Channel*>::iterator it = channelsCopy.begin(); 
-         it != channelsCopy.end(); ++it) {
-        Channel* channel = *it;
-        std::string quitMsg = ":" + client->getPrefix() + " QUIT :" + reason;
-        channel->broadcast(quitMsg, client);
-        channel->removeMember(client);
+    std::vector<Channel*> joinedChannels = client->getJoinedChannels();
+    for (size_t i = 0; i < joinedChannels.size(); i++) {
+        leaveChannel(joinedChannels[i], client);
     }
     
-    client->queueMessage("Quitting session: " + client->getNickname() + " (" + reason + ")");
+    client->queueMessage(ReplyBuilder() << "Quitting session: " << client->getNickname() << " ("
+                                        << reason << ")");
     client->setMarkedForRemoval(true);
-    cleanupEmptyChannels();
 }
 
-void Server::cmdPing(Client* client, const std::vector<std::string>& tokens) {
-    if (tokens.size() < 2) {
-        client->queueMessage("409 :No origin specified");
+void Server::cmdPing(Client* client, const IrcMessage& msg) {
+    if (msg.paramCount < 1) {
+        sendNumeric(client, ERR_NOORIGIN);
         return;
     }
     
-    client->queueMessage("PONG " + serverName + " :" + tokens[1]);
+    client->queueMessage(ReplyBuilder() << "PONG " << serverName << " :" << msg.params[0]);
+}
+
+// the keepalive only needs to know the PING was answered
+void Server::cmdPong(Client* client, const IrcMessage&) {
+    client->setPingSentAt(0);
+}
+
+// STATS m: how often each command was used and how many bytes it carried
+void Server::cmdStats(Client* client, const IrcMessage& msg) {
+    std::string query = (msg.paramCount >= 1) ? msg.params[0].str() : "*";
+    
+    if (query == "m" || query == "M") {
+        for (size_t i = 0; i < commandStats.size(); i++) {
+            unsigned long callCount = __atomic_load_n(&commandStats[i].calls, __ATOMIC_RELAXED);
+            if (callCount == 0) {
+                continue;
+            }
+            ReplyBuilder calls;
+            ReplyBuilder bytes;
+            calls << callCount;
+            bytes << __atomic_load_n(&commandStats[i].bytes, __ATOMIC_RELAXED);
+            sendNumeric(client, RPL_STATSCOMMANDS, commandTable[i].name, calls, bytes);
+        }
+    } else if (query == "l" || query == "L") {
+        // every connection of every reactor: the tables only change under the state lock
+        for (size_t r = 0; r < reactors.size(); r++) {
+            ConnectionTable& connections = reactors[r]->getConnections();
+            for (size_t i = 0; i < connections.size(); i++) {
+                Client* peer = connections.at(i);
+                std::string name = peer->getNickname().empty() ? "*" : peer->getNickname();
+                ReplyBuilder line;
+                line << name << "[" << peer->getHostname() << "] "
+                     << peer->getSendQDepth() << " " << peer->getSendQPeak() << " "
+                     << peer->getSendQLimit() << " " << peer->getSendQDropped();
+                sendNumeric(client, RPL_STATSLINKINFO, line);
+            }
+        }
+    } else if (query == "z" || query == "Z") {
+        // slab pools: objects in use against what the slabs hold
+        for (SlabAllocator* pool = SlabAllocator::first(); pool != NULL; pool = pool->next()) {
+            SlabAllocator::Usage usage = pool->getUsage();
+            ReplyBuilder line;
+            line << pool->getName() << " size " << pool->getObjectSize() << " used " << usage.inUse
+                 << " free " << (usage.capacity - usage.inUse) << " peak " << usage.peak
+                 << " slabs " << usage.slabs;
+            sendNumeric(client, RPL_STATSDEBUG, "z", line);
+        }
+    }
+    sendNumeric(client, RPL_ENDOFSTATS, query);
 }
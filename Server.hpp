@@ -6,7 +6,7 @@
 /*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/10 15:18:12 by kbrauer           #+#    #+#             */
-/*   Updated: 2025/12/19 18:17:02 by kbrauer          ###   ########.fr       */
+/*   Updated: 2026/10/17 02:25:35 by kbrauer          ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -17,15 +17,23 @@
 
 #include <string>
 #include <vector>
-#include <map>
-#include <poll.h>
 #include <netinet/in.h>
+#include "ServerConfig.hpp"
+#include "RwLock.hpp"
+#include "StringRef.hpp"
+#include "NameIndex.hpp"
+#include "IntrusiveList.hpp"
+#include "Channel.hpp"
+#include "Numerics.hpp"
 
 /*
 001 RPL_WELCOME
 002 RPL_YOURHOST
 003 RPL_CREATED
 004 RPL_MYINFO
+211 RPL_STATSLINKINFO
+212 RPL_STATSCOMMANDS
+219 RPL_ENDOFSTATS
 324 RPL_CHANNELMODEIS
 331 RPL_NOTOPIC
 332 RPL_TOPIC
@@ -40,6 +48,7 @@
 404 ERR_CANNOTSENDTOCHAN
 411 ERR_NORECIPIENT
 412 ERR_NOTEXTTOSEND
+417 ERR_INPUTTOOLONG
 421 ERR_UNKNOWNCOMMAND
 431 ERR_NONICKNAMEGIVEN
 432 ERR_ERRONEUSNICKNAME
@@ -61,52 +70,116 @@
 
 class Client;
 class Channel;
+class Reactor;
+struct IrcMessage;
 
+// Reactors own sockets and buffers; nick and channel state is shared between
+// them. commands that only read it run in parallel under stateLock held shared,
+// anything that changes it holds stateLock exclusively
 class Server {
 private:
-    int serverSocket;
+    typedef void (Server::*CommandHandler)(Client* client, const IrcMessage& msg);
+    
+    // dispatch table entry: the checks every handler would otherwise repeat
+    struct CommandSpec {
+        const char* name;
+        CommandHandler handler;
+        size_t minParams;           // fewer parameters: 461
+        bool needsRegistration;     // unregistered clients: 451
+        bool rejectsRegistered;     // registered clients: 462
+        bool readsOnly;             // leaves nick/channel state alone: stateLock shared
+    };
+    
+    // per command usage, shown by STATS m; bumped atomically by every reactor
+    struct CommandStats {
+        unsigned long calls;
+        unsigned long bytes;
+    };
+    
+    static const CommandSpec commandTable[];
+    static int findCommand(const StringRef& command);
+    
     int port;
     std::string password;
     std::string serverName;
+    std::string serverVersion;
+    std::string createdAt;
+    ServerConfig config;
+    
+    std::vector<Reactor*> reactors;
+    NameIndex<Channel> channels;
+    IntrusiveList<Channel, &Channel::idleHook> idleChannels;   // oldest first
+    NameIndex<Client> nicknames;
+    RwLock stateLock;
+    unsigned long nextConnectionId;
+    unsigned long fanoutEpoch;
+    std::vector<CommandStats> commandStats;
     
-    std::vector<struct pollfd> pollFds;
-    std::map<int, Client*> clients;
-    std::map<std::string, Channel*> channels;
+    volatile bool isRunning;
     
-    bool isRunning;
+    // lines one client may have parsed per loop iteration before the others get a turn
+    static const size_t COMMAND_BUDGET = 16;
+    // how long a dropped client gets to take its last lines on a completion backend
+    static const unsigned long LINGER_MS = 2000;
 
-    void setupServerSocket();
-    void acceptNewClient();
-    void handleClientData(int clientFd);
-    void handleClientWrite(int clientFd);
-    void removeClient(int clientFd);
-    void parseCommand(Client* client, const std::string& message);
+    static void* reactorThread(void* arg);
+    void runReactor(Reactor* reactor);
+    void acceptNewClient(Reactor* reactor);
+    void handleAcceptedClient(Reactor* reactor, int clientSocket);
+    void registerClient(Reactor* reactor, int clientSocket, const struct sockaddr_in& clientAddr);
+    void handleClientData(Reactor* reactor, int clientFd);
+    void handleReceivedData(Reactor* reactor, int clientFd, const char* data, size_t length);
+    void processInput(Client* client, size_t& budget);
+    void pauseInput(Reactor* reactor, Client* client);
+    void closeInput(Reactor* reactor, Client* client, size_t& budget);
+    void resumeInput(Reactor* reactor, Client* client);
+    void serviceBacklog(Reactor* reactor);
+    void handleClientWrite(Reactor* reactor, int clientFd);
+    void handleSendCompleted(Reactor* reactor, int clientFd, int result);
+    void removeClient(Reactor* reactor, int clientFd);
+    void detachClient(Client* client);
+    bool lingerClient(Reactor* reactor, Client* client);
+    void parseCommand(Client* client, const char* line, size_t length);
     
     bool isValidNickname(const std::string& nick) const;
-    bool isValidChannelName(const std::string& name) const;
+    bool isValidChannelName(const StringRef& name) const;
     
     // commands
-    void cmdPass(Client* client, const std::vector<std::string>& tokens);
-    void cmdNick(Client* client, const std::vector<std::string>& tokens);
-    void cmdUser(Client* client, const std::vector<std::string>& tokens);
-    void cmdJoin(Client* client, const std::vector<std::string>& tokens);
-    void cmdPart(Client* client, const std::vector<std::string>& tokens);
-    void cmdPrivmsg(Client* client, const std::vector<std::string>& tokens);
-    void cmdKick(Client* client, const std::vector<std::string>& tokens);
-    void cmdInvite(Client* client, const std::vector<std::string>& tokens);
-    void cmdTopic(Client* client, const std::vector<std::string>& tokens);
-    void cmdMode(Client* client, const std::vector<std::string>& tokens);
-    void cmdQuit(Client* client, const std::vector<std::string>& tokens);
-    void cmdPing(Client* client, const std::vector<std::string>& tokens);
+    void cmdPass(Client* client, const IrcMessage& msg);
+    void cmdNick(Client* client, const IrcMessage& msg);
+    void cmdUser(Client* client, const IrcMessage& msg);
+    void cmdJoin(Client* client, const IrcMessage& msg);
+    void cmdPart(Client* client, const IrcMessage& msg);
+    void cmdPrivmsg(Client* client, const IrcMessage& msg);
+    void cmdKick(Client* client, const IrcMessage& msg);
+    void cmdInvite(Client* client, const IrcMessage& msg);
+    void cmdTopic(Client* client, const IrcMessage& msg);
+    void cmdMode(Client* client, const IrcMessage& msg);
+    void cmdQuit(Client* client, const IrcMessage& msg);
+    void cmdPing(Client* client, const IrcMessage& msg);
+    void cmdPong(Client* client, const IrcMessage& msg);
+    void cmdStats(Client* client, const IrcMessage& msg);
     
     void tryCompleteRegistration(Client* client);
-    void updatePollEvents(int fd, short events);
-    void sendAllData();
-    void removeMarkedClients();
-    void cleanupEmptyChannels();
+    void applySendQClass(Client* client);
+    void sendAllData(Reactor* reactor);
+    void removeMarkedClients(Reactor* reactor);
+    void broadcastToPeers(Client* client, const StringRef& message);
+    void sendNumeric(Client* client, Numeric numeric, const StringRef& first = StringRef(),
+                     const StringRef& second = StringRef(), const StringRef& third = StringRef());
+    void sendNames(Client* client, Channel* channel);
+    void leaveChannel(Channel* channel, Client* client);
+    void retireChannel(Channel* channel);
+    void reclaimIdleChannels(unsigned long now);
+    static void channelSweepExpired(void* context);
+    void sweepIdleChannels(Reactor* reactor);
+    static void keepaliveExpired(void* context);
+    void handleKeepalive(Client* client);
+    void closeLink(Client* client, const StringRef& reason);
+    void destroyChannel(Channel* channel);
     
 public:
-    Server(int port, const std::string& password);
+    Server(int port, const std::string& password, const ServerConfig& config);
     ~Server();
     
     void start();
@@ -114,8 +187,8 @@ public:
     
     const std::string& getPassword() const;
     const std::string& getServerName() const;
-    Client* getClientByNickname(const std::string& nickname);
-    Channel* getChannel(const std::string& channelName);
+    Client* getClientByNickname(const StringRef& nickname);
+    Channel* getChannel(const StringRef& channelName);
     Channel* createChannel(const std::string& channelName, Client* creator);
 };
 
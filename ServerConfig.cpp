@@ -0,0 +1,146 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ServerConfig.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:29:31 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 01:35:39 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "ServerConfig.hpp"
+#include <cstdlib>
+
+ServerConfig::ServerConfig()
+    : backend("epoll"),
+      threads(1),
+      channelGrace(0),
+      sendqUnregistered(65536),
+      sendqUser(1048576),
+      sendqSoftPercent(75),
+      floodRate(20),
+      floodBurst(40),
+      pingInterval(120),
+      pingTimeout(60),
+      registerTimeout(60),
+      logLevel(Logger::LEVEL_INFO),
+      logSample(1) {
+}
+
+static bool parseNumber(const std::string& value, long min, long max, long& result) {
+    char* endptr;
+    if (value.empty())
+        return false;
+    result = std::strtol(value.c_str(), &endptr, 10);
+    return *endptr == '\0' && result >= min && result <= max;
+}
+
+bool ServerConfig::parseOption(const std::string& arg, std::string& error) {
+    size_t eq = arg.find('=');
+    if (arg.compare(0, 2, "--") != 0 || eq == std::string::npos) {
+        error = "options must look like --name=value";
+        return false;
+    }
+    std::string name = arg.substr(2, eq - 2);
+    std::string value = arg.substr(eq + 1);
+    
+    if (name == "backend") {
+        if (value != "io_uring" && value != "epoll" && value != "poll") {
+            error = "backend must be 'io_uring', 'epoll' or 'poll'";
+            return false;
+        }
+        backend = value;
+        return true;
+    }
+    if (name == "threads") {
+        long number;
+        if (!parseNumber(value, 1, 64, number)) {
+            error = "threads must be between 1 and 64";
+            return false;
+        }
+        threads = number;
+        return true;
+    }
+    if (name == "channel-grace") {
+        long number;
+        if (!parseNumber(value, 0, 3600, number)) {
+            error = "channel-grace must be between 0 and 3600 seconds";
+            return false;
+        }
+        channelGrace = number;
+        return true;
+    }
+    if (name == "sendq" || name == "sendq-unregistered") {
+        long number;
+        if (!parseNumber(value, 4096, 1L << 30, number)) {
+            error = name + " must be between 4096 and 1073741824 bytes";
+            return false;
+        }
+        if (name == "sendq")
+            sendqUser = number;
+        else
+            sendqUnregistered = number;
+        return true;
+    }
+    if (name == "sendq-soft") {
+        long number;
+        if (!parseNumber(value, 1, 100, number)) {
+            error = "sendq-soft must be between 1 and 100 percent";
+            return false;
+        }
+        sendqSoftPercent = number;
+        return true;
+    }
+    if (name == "flood-rate") {
+        long number;
+        if (!parseNumber(value, 0, 100000, number)) {
+            error = "flood-rate must be between 0 and 100000 lines per second";
+            return false;
+        }
+        floodRate = number;
+        return true;
+    }
+    if (name == "flood-burst") {
+        long number;
+        if (!parseNumber(value, 1, 100000, number)) {
+            error = "flood-burst must be between 1 and 100000 lines";
+            return false;
+        }
+        floodBurst = number;
+        return true;
+    }
+    if (name == "ping-interval" || name == "ping-timeout" || name == "register-timeout") {
+        long number;
+        if (!parseNumber(value, 1, 86400, number)) {
+            error = name + " must be between 1 and 86400 seconds";
+            return false;
+        }
+        if (name == "ping-interval")
+            pingInterval = number;
+        else if (name == "ping-timeout")
+            pingTimeout = number;
+        else
+            registerTimeout = number;
+        return true;
+    }
+    if (name == "log-level") {
+        if (!Logger::parseLevel(value, logLevel)) {
+            error = "log-level must be 'error', 'warn', 'info' or 'debug'";
+            return false;
+        }
+        return true;
+    }
+    if (name == "log-sample") {
+        long number;
+        if (!parseNumber(value, 1, 1000000, number)) {
+            error = "log-sample must be between 1 and 1000000";
+            return false;
+        }
+        logSample = number;
+        return true;
+    }
+    error = "unknown option '" + name + "'";
+    return false;
+}
@@ -0,0 +1,42 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ServerConfig.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:29:31 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 01:35:39 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef SERVERCONFIG_HPP
+#define SERVERCONFIG_HPP
+
+#include <string>
+#include <cstddef>
+#include <ctime>
+#include "Logger.hpp"
+
+// optional startup settings, given after <port> <password> as --name=value
+struct ServerConfig {
+    std::string backend;    // --backend=io_uring|epoll|poll
+    size_t threads;         // --threads=N reactor threads sharing the port
+    time_t channelGrace;    // --channel-grace=SECONDS an emptied channel is kept for reuse
+    size_t sendqUnregistered;   // --sendq-unregistered=BYTES queued output before registration
+    size_t sendqUser;           // --sendq=BYTES queued output of a registered client
+    size_t sendqSoftPercent;    // --sendq-soft=PERCENT of the limit where channel messages are dropped
+    unsigned long floodRate;    // --flood-rate=N lines per second once the burst is used, 0 = no limit
+    unsigned long floodBurst;   // --flood-burst=N lines a client may send at once
+    unsigned long pingInterval;     // --ping-interval=SECONDS of silence before the server PINGs
+    unsigned long pingTimeout;      // --ping-timeout=SECONDS to answer that PING
+    unsigned long registerTimeout;  // --register-timeout=SECONDS to finish PASS/NICK/USER
+    Logger::Level logLevel;     // --log-level=error|warn|info|debug, debug logs every received line
+    unsigned long logSample;    // --log-sample=N keeps one debug record in N
+
+    ServerConfig();
+
+    bool parseOption(const std::string& arg, std::string& error);
+};
+
+#endif
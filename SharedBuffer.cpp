@@ -0,0 +1,107 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   SharedBuffer.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:49:06 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 01:05:05 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "SharedBuffer.hpp"
+#include "BufferPool.hpp"
+#include <cstring>
+#include <new>
+
+// length of the message without stray line endings, and whether \r\n has to be added
+static size_t lineBody(const StringRef& message, bool& addCrlf) {
+    size_t end = message.size();
+    addCrlf = !(end >= 2 && message[end - 2] == '\r' && message[end - 1] == '\n');
+    if (addCrlf) {
+        while (end > 0 && (message[end - 1] == '\r' || message[end - 1] == '\n')) {
+            end--;
+        }
+    }
+    return end;
+}
+
+// header and bytes live in one pooled block, the bytes right behind the object
+SharedBuffer::SharedBuffer(size_t capacity)
+    : refCount(1), length(0), capacity(capacity) {
+}
+
+SharedBuffer::~SharedBuffer() {
+}
+
+SharedBuffer* SharedBuffer::withCapacity(size_t capacity) {
+    size_t blockSize = sizeof(SharedBuffer) + capacity;
+    void* memory = BufferPool::allocate(blockSize);
+    return new (memory) SharedBuffer(blockSize - sizeof(SharedBuffer));
+}
+
+SharedBuffer* SharedBuffer::fromLine(const StringRef& message) {
+    bool addCrlf;
+    size_t end = lineBody(message, addCrlf);
+    SharedBuffer* buffer = withCapacity(addCrlf ? end + 2 : end);
+    buffer->appendLine(message);
+    return buffer;
+}
+
+void SharedBuffer::retain() {
+    __atomic_add_fetch(&refCount, 1, __ATOMIC_RELAXED);
+}
+
+void SharedBuffer::release() {
+    if (__atomic_sub_fetch(&refCount, 1, __ATOMIC_ACQ_REL) != 0) {
+        return;
+    }
+    size_t blockSize = sizeof(SharedBuffer) + capacity;
+    this->~SharedBuffer();
+    BufferPool::deallocate(this, blockSize);
+}
+
+bool SharedBuffer::isShared() const {
+    return __atomic_load_n(&refCount, __ATOMIC_ACQUIRE) > 1;
+}
+
+bool SharedBuffer::appendLine(const StringRef& message) {
+    bool addCrlf;
+    size_t end = lineBody(message, addCrlf);
+    size_t total = addCrlf ? end + 2 : end;
+    if (total > capacity - length) {
+        return false;
+    }
+    char* bytes = reinterpret_cast<char*>(this + 1) + length;
+    std::memcpy(bytes, message.data, end);
+    if (addCrlf) {
+        bytes[end] = '\r';
+        bytes[end + 1] = '\n';
+    }
+    length += total;
+    return true;
+}
+
+bool SharedBuffer::appendPieces(const StringRef* pieces, int count, size_t total) {
+    if (total + 2 > capacity - length) {
+        return false;
+    }
+    char* bytes = reinterpret_cast<char*>(this + 1) + length;
+    for (int i = 0; i < count; i++) {
+        std::memcpy(bytes, pieces[i].data, pieces[i].length);
+        bytes += pieces[i].length;
+    }
+    bytes[0] = '\r';
+    bytes[1] = '\n';
+    length += total + 2;
+    return true;
+}
+
+const char* SharedBuffer::data() const {
+    return reinterpret_cast<const char*>(this + 1);
+}
+
+size_t SharedBuffer::size() const {
+    return length;
+}
@@ -0,0 +1,53 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   SharedBuffer.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 22:49:06 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 01:05:05 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef SHAREDBUFFER_HPP
+#define SHAREDBUFFER_HPP
+
+#include <cstddef>
+#include "StringRef.hpp"
+
+// serialized IRC lines (CRLF included), shared by every client they are queued to.
+// shared buffers are immutable; a buffer only one queue holds may still grow at the
+// end, which never touches bytes the kernel may be reading. the last release()
+// frees it, from whichever thread, into that thread's BufferPool.
+class SharedBuffer {
+private:
+    int refCount;
+    size_t length;
+    size_t capacity;
+
+    SharedBuffer(size_t capacity);
+    ~SharedBuffer();
+    SharedBuffer(const SharedBuffer& other);
+    SharedBuffer& operator=(const SharedBuffer& other);
+
+public:
+    // copies the message once and makes sure it ends with a single \r\n.
+    // the caller owns the first reference
+    static SharedBuffer* fromLine(const StringRef& message);
+    // empty buffer with room for at least capacity bytes
+    static SharedBuffer* withCapacity(size_t capacity);
+
+    void retain();
+    void release();
+    bool isShared() const;
+    // only for unshared buffers; false when the line does not fit
+    bool appendLine(const StringRef& message);
+    // one line out of pieces whose lengths add up to total, \r\n added
+    bool appendPieces(const StringRef* pieces, int count, size_t total);
+
+    const char* data() const;
+    size_t size() const;
+};
+
+#endif
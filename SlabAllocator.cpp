@@ -0,0 +1,267 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   SlabAllocator.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 00:27:34 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 02:30:24 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "SlabAllocator.hpp"
+#include <new>
+
+// zero-initialized before any constructor runs, so allocators defined in
+// other files may register in any order
+SlabAllocator* SlabAllocator::registry = NULL;
+int SlabAllocator::allocatorCount = 0;
+
+// objects are 16-byte aligned, like the heap's
+static const size_t ALIGNMENT = 16;
+
+// roughly how much memory a refill moves into a thread cache
+static const size_t BATCH_BYTES = 8192;
+
+static size_t alignUp(size_t size) {
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+struct CachedObject {
+    CachedObject* next;
+};
+
+// one per thread that touched a pool. live counts the allocations minus the
+// frees made on that thread, so it goes negative on a thread that frees what
+// another one allocated; only the sum over all threads means anything, and
+// the record outlives its thread for that reason
+struct ThreadCache {
+    CachedObject* objects[SlabAllocator::MAX_CACHED];
+    size_t count[SlabAllocator::MAX_CACHED];
+    long live[SlabAllocator::MAX_CACHED];
+    ThreadCache* next;
+};
+
+static __thread ThreadCache* threadCache;
+static ThreadCache* allCaches = NULL;
+static Mutex cachesLock;
+
+static ThreadCache* localCache() {
+    if (!threadCache) {
+        ThreadCache* cache = new ThreadCache();
+        ScopedLock guard(cachesLock);
+        cache->next = allCaches;
+        allCaches = cache;
+        threadCache = cache;
+    }
+    return threadCache;
+}
+
+// only the owning thread writes the counter, STATS z reads it from another
+static void addLive(ThreadCache* cache, int index, long delta) {
+    __atomic_store_n(&cache->live[index], cache->live[index] + delta, __ATOMIC_RELAXED);
+}
+
+SlabAllocator::SlabAllocator(const char* poolName, size_t size)
+    : name(poolName),
+      objectSize(alignUp(size < sizeof(FreeObject) ? sizeof(FreeObject) : size)),
+      perSlab(0),
+      index(allocatorCount++),
+      batch(0),
+      freeList(NULL),
+      carveNext(NULL),
+      carveEnd(NULL),
+      slabs(NULL),
+      nextAllocator(registry) {
+    // the slab header takes the first aligned chunk
+    size_t room = SLAB_SIZE - alignUp(sizeof(Slab));
+    perSlab = room / objectSize;
+    if (perSlab == 0)
+        perSlab = 1;
+    batch = BATCH_BYTES / objectSize;
+    if (batch < 2)
+        batch = 2;
+    if (batch > 32)
+        batch = 32;
+    usage.inUse = 0;
+    usage.capacity = 0;
+    usage.peak = 0;
+    usage.slabs = 0;
+    registry = this;
+}
+
+void SlabAllocator::addSlab() {
+    char* memory = static_cast<char*>(::operator new(alignUp(sizeof(Slab)) + perSlab * objectSize));
+    Slab* slab = reinterpret_cast<Slab*>(memory);
+    slab->next = slabs;
+    slabs = slab;
+    carveNext = memory + alignUp(sizeof(Slab));
+    carveEnd = carveNext + perSlab * objectSize;
+    usage.capacity += perSlab;
+    usage.slabs++;
+}
+
+// caller holds the lock
+void* SlabAllocator::takeShared() {
+    void* object;
+    if (freeList) {
+        object = freeList;
+        freeList = freeList->next;
+    } else {
+        // a fresh slab is handed out front to back, so objects created
+        // together sit next to each other
+        if (carveNext == carveEnd)
+            addSlab();
+        object = carveNext;
+        carveNext += objectSize;
+    }
+    usage.inUse++;
+    if (usage.inUse > usage.peak)
+        usage.peak = usage.inUse;
+    return object;
+}
+
+void SlabAllocator::refill() {
+    ThreadCache* cache = threadCache;
+    ScopedLock guard(lock);
+    for (size_t i = 0; i < batch; i++) {
+        CachedObject* object = static_cast<CachedObject*>(takeShared());
+        object->next = cache->objects[index];
+        cache->objects[index] = object;
+        cache->count[index]++;
+    }
+}
+
+void SlabAllocator::drain(size_t count) {
+    ThreadCache* cache = threadCache;
+    ScopedLock guard(lock);
+    for (size_t i = 0; i < count && cache->objects[index]; i++) {
+        CachedObject* object = cache->objects[index];
+        cache->objects[index] = object->next;
+        cache->count[index]--;
+        FreeObject* freed = reinterpret_cast<FreeObject*>(object);
+        freed->next = freeList;
+        freeList = freed;
+        usage.inUse--;
+    }
+}
+
+void* SlabAllocator::allocate() {
+    if (index >= MAX_CACHED) {
+        ScopedLock guard(lock);
+        return takeShared();
+    }
+    ThreadCache* cache = localCache();
+    if (!cache->objects[index])
+        refill();
+    CachedObject* object = cache->objects[index];
+    cache->objects[index] = object->next;
+    cache->count[index]--;
+    addLive(cache, index, 1);
+    return object;
+}
+
+void SlabAllocator::deallocate(void* object) {
+    if (!object)
+        return;
+    if (index >= MAX_CACHED) {
+        ScopedLock guard(lock);
+        FreeObject* freed = static_cast<FreeObject*>(object);
+        freed->next = freeList;
+        freeList = freed;
+        usage.inUse--;
+        return;
+    }
+    ThreadCache* cache = localCache();
+    CachedObject* freed = static_cast<CachedObject*>(object);
+    freed->next = cache->objects[index];
+    cache->objects[index] = freed;
+    cache->count[index]++;
+    addLive(cache, index, -1);
+    // a thread that frees more than it allocates (clients of another
+    // reactor, say) hands the surplus back to the shared list
+    if (cache->count[index] > 2 * batch)
+        drain(batch);
+}
+
+void SlabAllocator::releaseThreadCache() {
+    if (!threadCache)
+        return;
+    for (SlabAllocator* pool = registry; pool; pool = pool->nextAllocator) {
+        if (pool->index < MAX_CACHED)
+            pool->drain(threadCache->count[pool->index]);
+    }
+}
+
+// size classes for container storage (membership tables and the like)
+static SlabAllocator small32("small-32", 32);
+static SlabAllocator small64("small-64", 64);
+static SlabAllocator small128("small-128", 128);
+static SlabAllocator small256("small-256", 256);
+static SlabAllocator small512("small-512", 512);
+static SlabAllocator small1024("small-1024", 1024);
+static SlabAllocator small2048("small-2048", 2048);
+
+static SlabAllocator* const sizeClasses[] = {
+    &small32, &small64, &small128, &small256, &small512, &small1024, &small2048
+};
+static const int CLASS_COUNT = 7;
+
+static SlabAllocator* sizeClassOf(size_t size) {
+    for (int i = 0; i < CLASS_COUNT; i++) {
+        if (size <= sizeClasses[i]->getObjectSize())
+            return sizeClasses[i];
+    }
+    return NULL;
+}
+
+void* SlabAllocator::allocateSized(size_t size) {
+    SlabAllocator* sizeClass = sizeClassOf(size);
+    if (!sizeClass)
+        return ::operator new(size);
+    return sizeClass->allocate();
+}
+
+// callers pass the size they asked for, which picks the same class again
+void SlabAllocator::deallocateSized(void* memory, size_t size) {
+    SlabAllocator* sizeClass = sizeClassOf(size);
+    if (!sizeClass) {
+        ::operator delete(memory);
+        return;
+    }
+    sizeClass->deallocate(memory);
+}
+
+const char* SlabAllocator::getName() const {
+    return name;
+}
+
+size_t SlabAllocator::getObjectSize() const {
+    return objectSize;
+}
+
+SlabAllocator::Usage SlabAllocator::getUsage() const {
+    Usage result;
+    {
+        ScopedLock guard(lock);
+        result = usage;
+    }
+    if (index < MAX_CACHED) {
+        // objects sitting in thread caches are free, not used
+        long live = 0;
+        ScopedLock guard(cachesLock);
+        for (ThreadCache* cache = allCaches; cache; cache = cache->next)
+            live += __atomic_load_n(&cache->live[index], __ATOMIC_RELAXED);
+        result.inUse = live < 0 ? 0 : live;
+    }
+    return result;
+}
+
+SlabAllocator* SlabAllocator::first() {
+    return registry;
+}
+
+SlabAllocator* SlabAllocator::next() const {
+    return nextAllocator;
+}
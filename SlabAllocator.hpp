@@ -0,0 +1,93 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   SlabAllocator.hpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 00:27:34 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 02:30:24 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef SLABALLOCATOR_HPP
+#define SLABALLOCATOR_HPP
+
+#include <cstddef>
+#include "Mutex.hpp"
+
+// fixed-size objects carved out of 64 KiB slabs. freed objects go on a free
+// list and are handed out again first, so connection churn keeps reusing the
+// same memory instead of fragmenting the heap. slabs are never given back.
+// each thread keeps a small cache per pool and only takes the pool lock to
+// move a batch in or out, so a client freed on another thread goes back
+// through the shared list. every allocator is registered for STATS z.
+class SlabAllocator {
+public:
+    static const size_t SLAB_SIZE = 65536;
+    // pools past this count have no thread cache and always lock
+    static const int MAX_CACHED = 16;
+
+    struct Usage {
+        size_t inUse;
+        size_t capacity;    // objects in all slabs
+        size_t peak;        // thread caches count as in use here
+        size_t slabs;
+    };
+
+private:
+    struct FreeObject {
+        FreeObject* next;
+    };
+    struct Slab {
+        Slab* next;
+    };
+
+    const char* name;
+    size_t objectSize;
+    size_t perSlab;
+    int index;              // slot in the thread caches
+    size_t batch;           // objects moved per refill or drain
+    
+    mutable Mutex lock;
+    FreeObject* freeList;
+    char* carveNext;        // untouched tail of the newest slab
+    char* carveEnd;
+    Slab* slabs;
+    Usage usage;            // inUse counts everything off the shared list
+    
+    SlabAllocator* nextAllocator;
+    static SlabAllocator* registry;
+    static int allocatorCount;
+
+    void addSlab();
+    void* takeShared();
+    void refill();
+    void drain(size_t count);
+
+    SlabAllocator(const SlabAllocator& other);
+    SlabAllocator& operator=(const SlabAllocator& other);
+
+public:
+    SlabAllocator(const char* poolName, size_t size);
+
+    void* allocate();
+    void deallocate(void* object);
+
+    // size-classed pools for small container storage; bigger requests
+    // go to the heap
+    static void* allocateSized(size_t size);
+    static void deallocateSized(void* memory, size_t size);
+
+    // hands the calling thread's cached objects back to the pools
+    static void releaseThreadCache();
+
+    const char* getName() const;
+    size_t getObjectSize() const;
+    Usage getUsage() const;
+
+    static SlabAllocator* first();
+    SlabAllocator* next() const;
+};
+
+#endif
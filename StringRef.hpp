@@ -0,0 +1,56 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   StringRef.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 23:06:09 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 00:53:00 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef STRINGREF_HPP
+#define STRINGREF_HPP
+
+#include <string>
+#include <cstring>
+#include <cstddef>
+
+// non-owning view of a byte range, e.g. a token inside the input buffer.
+// only valid as long as the bytes it points to
+struct StringRef {
+    const char* data;
+    size_t length;
+
+    StringRef() : data(""), length(0) {}
+    StringRef(const char* d, size_t l) : data(d), length(l) {}
+    // implicit, so literals and strings go wherever a view is taken
+    StringRef(const char* text) : data(text), length(std::strlen(text)) {}
+    StringRef(const std::string& text) : data(text.data()), length(text.length()) {}
+
+    bool empty() const { return length == 0; }
+    size_t size() const { return length; }
+    char operator[](size_t i) const { return data[i]; }
+    std::string str() const { return std::string(data, length); }
+
+    bool operator==(const std::string& other) const {
+        return other.length() == length && std::memcmp(data, other.data(), length) == 0;
+    }
+    bool operator!=(const std::string& other) const { return !(*this == other); }
+
+    // upper must already be upper case, e.g. a command name
+    bool equalsIgnoreCase(const char* upper) const {
+        size_t i = 0;
+        for (; i < length && upper[i]; i++) {
+            char c = data[i];
+            if (c >= 'a' && c <= 'z')
+                c -= 'a' - 'A';
+            if (c != upper[i])
+                return false;
+        }
+        return i == length && upper[i] == '\0';
+    }
+};
+
+#endif
@@ -0,0 +1,169 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TimerWheel.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 00:11:22 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 00:11:22 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "TimerWheel.hpp"
+#include "Clock.hpp"
+
+Timer::Timer()
+    : prev(NULL),
+      next(NULL),
+      expires(0),
+      level(0),
+      slot(0),
+      armed(false),
+      callback(NULL),
+      context(NULL) {
+}
+
+TimerWheel::TimerWheel()
+    : current(monotonicMs() / TICK_MS),
+      armedCount(0) {
+    for (int level = 0; level < LEVELS; level++) {
+        occupied[level] = 0;
+        for (int slot = 0; slot < SLOTS; slot++) {
+            buckets[level][slot] = NULL;
+        }
+    }
+}
+
+// the lowest level whose range covers the distance; beyond the top level the
+// timer waits in the last bucket and gets placed again when that comes up
+void TimerWheel::link(Timer* timer) {
+    unsigned long expires = timer->expires < current ? current : timer->expires;
+    unsigned long delta = expires - current;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (1UL << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    if (delta >= (1UL << (SLOT_BITS * LEVELS))) {
+        expires = current + (1UL << (SLOT_BITS * LEVELS)) - 1;
+    }
+    int slot = (expires >> (SLOT_BITS * level)) & (SLOTS - 1);
+    
+    timer->level = level;
+    timer->slot = slot;
+    timer->prev = NULL;
+    timer->next = buckets[level][slot];
+    if (timer->next) {
+        timer->next->prev = timer;
+    }
+    buckets[level][slot] = timer;
+    occupied[level] |= 1UL << slot;
+}
+
+void TimerWheel::unlink(Timer* timer) {
+    if (timer->prev) {
+        timer->prev->next = timer->next;
+    } else {
+        buckets[timer->level][timer->slot] = timer->next;
+        if (!timer->next) {
+            occupied[timer->level] &= ~(1UL << timer->slot);
+        }
+    }
+    if (timer->next) {
+        timer->next->prev = timer->prev;
+    }
+    timer->prev = NULL;
+    timer->next = NULL;
+}
+
+void TimerWheel::schedule(Timer* timer, unsigned long delayMs, unsigned long nowMs) {
+    if (timer->armed) {
+        cancel(timer);
+    }
+    // never the tick being processed, a callback re-arming itself must not loop
+    unsigned long expires = (nowMs + delayMs + TICK_MS - 1) / TICK_MS;
+    timer->expires = expires > current ? expires : current + 1;
+    timer->armed = true;
+    link(timer);
+    armedCount++;
+}
+
+void TimerWheel::cancel(Timer* timer) {
+    if (!timer->armed) {
+        return;
+    }
+    unlink(timer);
+    timer->armed = false;
+    armedCount--;
+}
+
+// the bucket of this level that just came up is spread over the levels below
+void TimerWheel::cascade(int level) {
+    int slot = (current >> (SLOT_BITS * level)) & (SLOTS - 1);
+    if (slot == 0 && level + 1 < LEVELS) {
+        cascade(level + 1);
+    }
+    Timer* timer = buckets[level][slot];
+    buckets[level][slot] = NULL;
+    occupied[level] &= ~(1UL << slot);
+    while (timer) {
+        Timer* next = timer->next;
+        link(timer);
+        timer = next;
+    }
+}
+
+void TimerWheel::advance(unsigned long nowMs) {
+    unsigned long target = nowMs / TICK_MS;
+    while (current < target) {
+        // nothing armed: jump instead of walking every tick
+        if (armedCount == 0) {
+            current = target;
+            break;
+        }
+        current++;
+        int slot = current & (SLOTS - 1);
+        if (slot == 0) {
+            cascade(1);
+        }
+        // a callback may arm or cancel timers, take one at a time
+        Timer* timer;
+        while ((timer = buckets[0][slot]) != NULL) {
+            cancel(timer);
+            timer->callback(timer->context);
+        }
+    }
+}
+
+int TimerWheel::timeout(unsigned long nowMs) const {
+    if (armedCount == 0) {
+        return -1;
+    }
+    unsigned long next = 0;
+    bool found = false;
+    for (int level = 0; level < LEVELS; level++) {
+        if (!occupied[level]) {
+            continue;
+        }
+        int shift = SLOT_BITS * level;
+        unsigned long base = current >> shift;
+        // rotate so bit j is the bucket j + 1 after the current one; the
+        // current bucket itself ends up last, it comes up one round later
+        int shiftBy = ((base & (SLOTS - 1)) + 1) & (SLOTS - 1);
+        unsigned long rotated = occupied[level];
+        if (shiftBy) {
+            rotated = (rotated >> shiftBy) | (rotated << (SLOTS - shiftBy));
+        }
+        unsigned long distance = __builtin_ctzl(rotated) + 1;
+        unsigned long tick = (base + distance) << shift;
+        if (!found || tick < next) {
+            next = tick;
+            found = true;
+        }
+    }
+    unsigned long dueMs = next * TICK_MS;
+    if (dueMs <= nowMs) {
+        return 0;
+    }
+    return static_cast<int>(dueMs - nowMs);
+}
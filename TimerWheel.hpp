@@ -0,0 +1,74 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TimerWheel.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 00:11:22 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 00:11:22 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef TIMERWHEEL_HPP
+#define TIMERWHEEL_HPP
+
+#include <cstddef>
+
+// embedded in whatever it times; the owner cancels it before going away.
+// the callback runs on the wheel's reactor thread, the timer already disarmed,
+// so it may schedule the same timer again
+struct Timer {
+    Timer* prev;
+    Timer* next;
+    unsigned long expires;      // tick
+    int level;                  // bucket the timer is linked into
+    int slot;
+    bool armed;
+    void (*callback)(void* context);
+    void* context;
+
+    Timer();
+};
+
+// hierarchical timer wheel: 4 levels of 64 buckets, 100 ms ticks at the bottom.
+// scheduling and cancelling are O(1); a timer far out sits in a coarse bucket
+// and moves down a level each time its bucket comes up. a bitmap per level
+// finds the next occupied bucket, so the loop only wakes when there is work
+class TimerWheel {
+public:
+    static const unsigned long TICK_MS = 100;
+
+private:
+    enum {
+        LEVELS = 4,
+        SLOT_BITS = 6,
+        SLOTS = 1 << SLOT_BITS
+    };
+
+    Timer* buckets[LEVELS][SLOTS];
+    unsigned long occupied[LEVELS];     // bit per non-empty bucket
+    unsigned long current;              // last tick processed
+    size_t armedCount;
+
+    void link(Timer* timer);
+    void unlink(Timer* timer);
+    void cascade(int level);
+
+    TimerWheel(const TimerWheel& other);
+    TimerWheel& operator=(const TimerWheel& other);
+
+public:
+    TimerWheel();
+
+    // re-arms an armed timer; fires no earlier than delayMs from nowMs
+    void schedule(Timer* timer, unsigned long delayMs, unsigned long nowMs);
+    void cancel(Timer* timer);
+
+    // runs every timer due by nowMs
+    void advance(unsigned long nowMs);
+    // ms until the next occupied bucket comes up, -1 when nothing is armed
+    int timeout(unsigned long nowMs) const;
+};
+
+#endif
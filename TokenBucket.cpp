@@ -0,0 +1,69 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TokenBucket.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 23:48:48 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 00:27:19 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "TokenBucket.hpp"
+#include "Clock.hpp"
+
+static const unsigned long UNIT = 1000;
+
+TokenBucket::TokenBucket()
+    : rate(0),
+      capacity(0),
+      level(0),
+      stamp(0) {
+}
+
+void TokenBucket::configure(unsigned long tokensPerSecond, unsigned long burst) {
+    rate = tokensPerSecond;
+    capacity = burst * UNIT;
+    level = capacity;
+    stamp = monotonicMs();
+}
+
+// one token per 1000/rate ms, whole milliseconds carry over to the next refill
+void TokenBucket::refill(unsigned long now) {
+    if (rate == 0 || now <= stamp) {
+        return;
+    }
+    unsigned long elapsed = now - stamp;
+    stamp = now;
+    unsigned long missing = capacity - level;
+    // elapsed * rate is in thousandths of a token already
+    if (elapsed >= missing / rate + 1) {
+        level = capacity;
+    } else {
+        level += elapsed * rate;
+        if (level > capacity) {
+            level = capacity;
+        }
+    }
+}
+
+bool TokenBucket::take() {
+    if (rate == 0) {
+        return true;
+    }
+    if (level < UNIT) {
+        return false;
+    }
+    level -= UNIT;
+    return true;
+}
+
+unsigned long TokenBucket::delay(unsigned long now) const {
+    if (rate == 0 || level >= UNIT) {
+        return 0;
+    }
+    unsigned long elapsed = now > stamp ? now - stamp : 0;
+    unsigned long needed = (UNIT - level + rate - 1) / rate;
+    return needed > elapsed ? needed - elapsed : 0;
+}
@@ -0,0 +1,37 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TokenBucket.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/16 23:48:48 by kbrauer           #+#    #+#             */
+/*   Updated: 2026/10/17 00:27:19 by kbrauer          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef TOKENBUCKET_HPP
+#define TOKENBUCKET_HPP
+
+// flood control: every parsed line costs one token, tokens come back at a
+// fixed rate up to the burst size. counted in thousandths of a token so slow
+// rates refill smoothly. a rate of 0 never runs dry.
+class TokenBucket {
+private:
+    unsigned long rate;         // tokens per second
+    unsigned long capacity;     // burst, in thousandths
+    unsigned long level;        // in thousandths
+    unsigned long stamp;        // ms of the last refill
+
+public:
+    TokenBucket();
+
+    // starts full
+    void configure(unsigned long tokensPerSecond, unsigned long burst);
+    void refill(unsigned long now);
+    bool take();
+    // ms until the next whole token, 0 when one is available
+    unsigned long delay(unsigned long now) const;
+};
+
+#endif
@@ -6,11 +6,13 @@
 /*   By: kbrauer <kbrauer@student.42.fr>            +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/10 15:17:59 by kbrauer           #+#    #+#             */
-/*   Updated: 2025/12/19 18:01:58 by kbrauer          ###   ########.fr       */
+/*   Updated: 2026/10/17 01:35:39 by kbrauer          ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "Server.hpp"
+#include "ServerConfig.hpp"
+#include "Logger.hpp"
 #include <iostream>
 #include <cstdlib>
 #include <csignal>
@@ -21,10 +23,14 @@ Server* g_server = NULL;
 
 void signalHandler(int signal) {
     (void)signal;
-    std::cout << "\nReceived signal, shutting down server..." << std::endl;
+    // the interrupted code may be about to look at errno
+    int savedErrno = errno;
+    // lock-free and only write(2) underneath, safe to call from the handler
+    LOG(INFO) << "\nReceived signal, shutting down server...";
     if (g_server) {
         g_server->stop();
     }
+    errno = savedErrno;
 }
 
 bool isValidPort(const char* portStr, int& port) {
@@ -39,8 +45,12 @@ bool isValidPort(const char* portStr, int& port) {
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0] << " <port> <password>" << std::endl;
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <port> <password> [--backend=io_uring|epoll|poll] [--threads=N] [--channel-grace=SECONDS]"
+                  << " [--sendq=BYTES] [--sendq-unregistered=BYTES] [--sendq-soft=PERCENT]"
+                  << " [--flood-rate=N] [--flood-burst=N]"
+                  << " [--ping-interval=SECONDS] [--ping-timeout=SECONDS] [--register-timeout=SECONDS]"
+                  << " [--log-level=error|warn|info|debug] [--log-sample=N]" << std::endl;
         return 1;
     }
     
@@ -57,6 +67,15 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    ServerConfig config;
+    for (int i = 3; i < argc; i++) {
+        std::string error;
+        if (!config.parseOption(argv[i], error)) {
+            std::cerr << "Error: Invalid option '" << argv[i] << "': " << error << std::endl;
+            return 1;
+        }
+    }
+    
     struct sigaction sa;
     sa.sa_handler = signalHandler;
     sigemptyset(&sa.sa_mask);
@@ -81,18 +100,27 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    Logger::setLevel(config.logLevel);
+    Logger::setSampleRate(config.logSample);
+    if (!Logger::start()) {
+        std::cerr << "Error: Failed to start the log thread" << std::endl;
+        return 1;
+    }
+    
     try {
-        static Server server(port, password);
+        static Server server(port, password, config);
         g_server = &server;
         
-        std::cout << "Starting IRC server on port " << port << std::endl;
+        LOG(INFO) << "Starting IRC server on port " << port;
         server.start();
         
     } catch (const std::exception& e) {
-        std::cerr << "Error: " << e.what() << std::endl;
+        LOG(ERROR) << "Error: " << e.what();
+        Logger::stop();
         return 1;
     }
     
-    std::cout << "Server stopped." << std::endl;
+    LOG(INFO) << "Server stopped.";
+    Logger::stop();
     return 0;
 }